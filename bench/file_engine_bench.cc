@@ -0,0 +1,125 @@
+// 文件写入方式性能对比：原std::ofstream写入路径、缓冲写入、io_uring写入和内存映射写入
+// 用法：file_engine_bench [日志条数] [输出目录]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "tinylog/internal/log_utils.h"
+#include "tinylog/internal/sink_interface.h"
+
+namespace {
+
+using tinylog::internal::LogEvent;
+using tinylog::internal::SinkInterface;
+
+// 原FileSink的写入路径：每条日志加锁、定位到文件末尾查询大小后通过std::ofstream写入
+class OfstreamSink : public SinkInterface {
+public:
+    explicit OfstreamSink(const std::string& file_path) : log_file_(file_path, std::ios::out | std::ios::app) {}
+
+    void flush() override {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        log_file_.flush();
+    }
+
+protected:
+    void write(std::string_view message, tinylog::LogLevel level) override {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        log_file_.seekp(0, std::ios::end);
+        if (static_cast<size_t>(log_file_.tellp()) >= kMaxFileSize) {
+            return;  // 不计入滚动的开销
+        }
+        log_file_ << message;
+    }
+
+private:
+    static constexpr size_t kMaxFileSize = SIZE_MAX;
+
+    std::ofstream log_file_;
+    std::mutex file_mutex_;
+};
+
+struct BenchCase {
+    const char* name;
+    std::function<std::shared_ptr<SinkInterface>(const std::string&)> create;
+};
+
+void RunCase(const BenchCase& bench_case, const std::string& dir, size_t count) {
+    std::string path = dir + "/" + bench_case.name + ".log";
+    std::filesystem::remove(path);
+
+    LogEvent event;
+    event.message = "benchmark message with a typical payload length for a service log line";
+    event.level = tinylog::LogLevel::kInfo;
+    event.filename = __FILE__;
+    event.function = __FUNCTION__;
+    event.line = __LINE__;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::shared_ptr<SinkInterface> sink = bench_case.create(path);
+        for (size_t i = 0; i < count; ++i) {
+            event.timestamp = tinylog::internal::GetCurrentTimeNanos();
+            sink->log(event);
+        }
+        sink->flush();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::error_code ec;
+    double megabytes = static_cast<double>(std::filesystem::file_size(path, ec)) / (1024.0 * 1024.0);
+    printf("%-10s %10.3f s %10.1f ns/record %10.1f MB/s\n", bench_case.name, elapsed, elapsed * 1e9 / count,
+           megabytes / elapsed);
+    std::filesystem::remove(path);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::string dir = argc > 2 ? argv[2] : "./file_engine_bench_logs";
+    std::filesystem::create_directories(dir);
+
+    // 不触发滚动，只比较写入本身
+    tinylog::internal::RotationPolicy rotation_policy;
+    rotation_policy.max_file_size = SIZE_MAX / 2;
+    tinylog::internal::FlushPolicy flush_policy;
+    flush_policy.interval_ms = 0;
+    flush_policy.flush_level = tinylog::LogLevel::kFatal;
+
+    BenchCase cases[] = {
+        {"ofstream", [](const std::string& path) { return std::make_shared<OfstreamSink>(path); }},
+        {"buffered",
+         [&](const std::string& path) {
+             return std::make_shared<tinylog::internal::FileSink>(path, rotation_policy, flush_policy,
+                                                                  tinylog::FileEngine::kBuffered);
+         }},
+        {"io_uring",
+         [&](const std::string& path) {
+             return std::make_shared<tinylog::internal::FileSink>(path, rotation_policy, flush_policy,
+                                                                  tinylog::FileEngine::kIoUring);
+         }},
+        {"mmap",
+         [&](const std::string& path) {
+             tinylog::internal::RotationPolicy mmap_policy = rotation_policy;
+             mmap_policy.max_file_size = 256 * 1024 * 1024;
+             return std::make_shared<tinylog::internal::MmapFileSink>(path, mmap_policy);
+         }},
+    };
+
+    printf("Writing %zu records per engine to %s\n", count, dir.c_str());
+    for (const auto& bench_case : cases) {
+        RunCase(bench_case, dir, count);
+    }
+    std::filesystem::remove_all(dir);
+    return 0;
+}
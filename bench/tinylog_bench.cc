@@ -0,0 +1,290 @@
+// Logger::Log的吞吐量和单次调用延迟基准测试
+// 覆盖输出目标（console/file/both）、同步与异步、级别启用与被过滤、短消息与长消息、1~N个线程的组合，
+// 人类可读的汇总输出到stderr，机器可读的结果写入JSON文件，供CI比较以发现性能回退。
+// 用法：tinylog_bench [--records N] [--threads 1,2,4] [--filter 子串] [--json 结果文件] [--dir 日志目录]
+// 日志文件写在日志目录下本次运行新建的子目录中，结束时只删除该子目录
+// 控制台输出目标的日志写到stdout，通常应重定向：tinylog_bench > /dev/null
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tinylog/logger.h"
+
+namespace {
+
+struct Options {
+    size_t records = 100000;  // 每个线程的日志条数
+    std::vector<int> threads = {1, 2, 4};
+    std::string filter;
+    std::string json_path = "tinylog_bench.json";
+    std::string dir = "./tinylog_bench_logs";
+};
+
+struct BenchCase {
+    std::string sink;     // console/file/both
+    bool async_mode;      // 同步或异步
+    bool enabled;         // 日志级别是否启用
+    bool long_message;    // 短消息或长消息
+    int threads;
+
+    std::string Name() const {
+        return sink + "/" + (async_mode ? "async" : "sync") + "/" + (enabled ? "enabled" : "filtered") + "/" +
+               (long_message ? "long" : "short") + "/t" + std::to_string(threads);
+    }
+};
+
+struct BenchResult {
+    BenchCase bench_case;
+    size_t records = 0;
+    double seconds = 0;
+    double throughput = 0;  // 每秒日志条数，包含异步模式下等待队列写完的时间
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t dropped = 0;
+};
+
+std::vector<int> ParseThreads(const char* list) {
+    std::vector<int> threads;
+    for (const char* p = list; *p != '\0';) {
+        char* end = nullptr;
+        long value = std::strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        if (value > 0) {
+            threads.push_back(static_cast<int>(value));
+        }
+        p = *end == ',' ? end + 1 : end;
+    }
+    return threads;
+}
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--records") == 0 && has_value) {
+            options.records = std::strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            options.threads = ParseThreads(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && has_value) {
+            options.json_path = argv[++i];
+        } else if (strcmp(argv[i], "--dir") == 0 && has_value) {
+            options.dir = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--records N] [--threads 1,2,4] [--filter substring] [--json file] [--dir log_dir]\n",
+                    argv[0]);
+            return false;
+        }
+    }
+    return options.records > 0 && !options.threads.empty();
+}
+
+tinylog::LogConfig MakeConfig(const BenchCase& bench_case, const std::string& file_path) {
+    tinylog::LogSink sink = tinylog::LogSink::kFile;
+    if (bench_case.sink == "console") {
+        sink = tinylog::LogSink::kConsole;
+    } else if (bench_case.sink == "both") {
+        sink = tinylog::LogSink::kBoth;
+    }
+    // 文件足够大，不触发滚动；队列满时阻塞，保证每条日志都被写出
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, sink, file_path, 2, SIZE_MAX / 4, bench_case.async_mode);
+    config.SetOverflowPolicy(tinylog::OverflowPolicy::kBlock);
+    config.SetFlushLevel(tinylog::LogLevel::kFatal);
+    return config;
+}
+
+uint64_t Percentile(const std::vector<uint32_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+// 日志级别需要是编译期常量，调用点描述符才能在编译期生成
+template <tinylog::LogLevel kLevel>
+void LogLoop(tinylog::Logger& logger, const std::string& message, size_t records, std::vector<uint32_t>& samples) {
+    for (size_t i = 0; i < records; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        TINYLOG_LOG_SITE(logger, kLevel, message);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(static_cast<uint32_t>(
+            std::min<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), UINT32_MAX)));
+    }
+}
+
+BenchResult RunCase(const BenchCase& bench_case, const Options& options, const std::string& run_dir) {
+    std::string file_path = run_dir + "/bench.log";
+    std::filesystem::remove(file_path);
+
+    const std::string message =
+        bench_case.long_message
+            ? std::string("request completed: method=GET path=/api/v1/orders/12345/items?page=3&limit=50 status=200 "
+                          "bytes=18432 upstream=orders-service-7f9c latency_ms=12.7 user_agent=Mozilla/5.0 "
+                          "trace=4bf92f3577b34da6a3ce929d0e0e4736")
+            : std::string("request done");
+
+    BenchResult result;
+    result.bench_case = bench_case;
+    std::vector<std::vector<uint32_t>> latencies(static_cast<size_t>(bench_case.threads));
+    {
+        tinylog::Logger logger(MakeConfig(bench_case, file_path));
+
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < bench_case.threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::vector<uint32_t>& samples = latencies[static_cast<size_t>(t)];
+                samples.reserve(options.records);
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                // 被过滤的用例以kDebug记录，低于配置的kInfo
+                if (bench_case.enabled) {
+                    LogLoop<tinylog::LogLevel::kInfo>(logger, message, options.records, samples);
+                } else {
+                    LogLoop<tinylog::LogLevel::kDebug>(logger, message, options.records, samples);
+                }
+            });
+        }
+
+        while (ready.load() < bench_case.threads) {
+            std::this_thread::yield();
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        logger.Flush();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.dropped = logger.GetDroppedCount();
+    }
+    std::filesystem::remove(file_path);
+
+    std::vector<uint32_t> all;
+    for (auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    result.records = all.size();
+    result.throughput = result.seconds > 0 ? static_cast<double>(result.records) / result.seconds : 0;
+    result.p50_ns = Percentile(all, 0.50);
+    result.p99_ns = Percentile(all, 0.99);
+    result.p999_ns = Percentile(all, 0.999);
+    result.max_ns = all.empty() ? 0 : all.back();
+    return result;
+}
+
+// 两次读取时钟之间的中位数耗时，即每个延迟样本中计时本身的开销
+uint64_t ClockOverhead() {
+    std::vector<uint32_t> samples(100000);
+    for (auto& sample : samples) {
+        auto start = std::chrono::steady_clock::now();
+        sample = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return Percentile(samples, 0.50);
+}
+
+bool WriteJson(const std::string& path, const Options& options, uint64_t clock_overhead,
+               const std::vector<BenchResult>& results) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        fprintf(stderr, "Failed to write %s\n", path.c_str());
+        return false;
+    }
+    fprintf(file,
+            "{\n  \"benchmark\": \"tinylog_bench\",\n  \"records_per_thread\": %zu,\n"
+            "  \"clock_overhead_ns\": %llu,\n  \"results\": [\n",
+            options.records, static_cast<unsigned long long>(clock_overhead));
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        const BenchCase& c = r.bench_case;
+        fprintf(file,
+                "    {\"name\": \"%s\", \"sink\": \"%s\", \"mode\": \"%s\", \"level\": \"%s\", \"message\": \"%s\", "
+                "\"threads\": %d, \"records\": %zu, \"seconds\": %.6f, \"throughput_per_sec\": %.1f, "
+                "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, \"dropped\": %llu}%s\n",
+                c.Name().c_str(), c.sink.c_str(), c.async_mode ? "async" : "sync",
+                c.enabled ? "enabled" : "filtered", c.long_message ? "long" : "short", c.threads, r.records,
+                r.seconds, r.throughput, static_cast<unsigned long long>(r.p50_ns),
+                static_cast<unsigned long long>(r.p99_ns), static_cast<unsigned long long>(r.p999_ns),
+                static_cast<unsigned long long>(r.max_ns), static_cast<unsigned long long>(r.dropped),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 2;
+    }
+    bool created_dir = std::filesystem::create_directories(options.dir);
+    std::string run_template = options.dir + "/tinylog_bench.XXXXXX";
+    if (mkdtemp(run_template.data()) == nullptr) {
+        fprintf(stderr, "cannot create a log directory under %s\n", options.dir.c_str());
+        return 1;
+    }
+    const std::string run_dir = run_template;
+
+    std::vector<BenchCase> cases;
+    for (const char* sink : {"console", "file", "both"}) {
+        for (bool async_mode : {false, true}) {
+            for (bool enabled : {true, false}) {
+                for (bool long_message : {false, true}) {
+                    for (int threads : options.threads) {
+                        BenchCase bench_case{sink, async_mode, enabled, long_message, threads};
+                        if (bench_case.Name().find(options.filter) != std::string::npos) {
+                            cases.push_back(bench_case);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    uint64_t clock_overhead = ClockOverhead();
+    fprintf(stderr, "clock overhead: %llu ns per sample\n", static_cast<unsigned long long>(clock_overhead));
+    fprintf(stderr, "%-32s %12s %10s %10s %10s %10s %8s\n", "case", "records/s", "p50 ns", "p99 ns", "p99.9 ns",
+            "max ns", "dropped");
+    std::vector<BenchResult> results;
+    for (const auto& bench_case : cases) {
+        BenchResult result = RunCase(bench_case, options, run_dir);
+        fprintf(stderr, "%-32s %12.0f %10llu %10llu %10llu %10llu %8llu\n", bench_case.Name().c_str(),
+                result.throughput, static_cast<unsigned long long>(result.p50_ns),
+                static_cast<unsigned long long>(result.p99_ns), static_cast<unsigned long long>(result.p999_ns),
+                static_cast<unsigned long long>(result.max_ns), static_cast<unsigned long long>(result.dropped));
+        results.push_back(result);
+    }
+
+    std::filesystem::remove_all(run_dir);
+    if (created_dir) {
+        std::error_code ec;
+        std::filesystem::remove(options.dir, ec);  // 只在目录为空时删除
+    }
+    return WriteJson(options.json_path, options, clock_overhead, results) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#ifndef TINYLOG_INTERNAL_ASYNC_QUEUE_H_
+#define TINYLOG_INTERNAL_ASYNC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace tinylog::internal {
+
+// 缓存行大小，用于隔离生产者和消费者频繁修改的原子变量，避免伪共享
+inline constexpr size_t kCacheLineSize = 64;
+
+// 有界无锁队列（基于每个槽位的序号实现），支持多生产者并发入队；
+// 出队同样是无锁的，因此在丢弃最旧日志的策略下生产者也可以安全地弹出队首元素。
+// 若队列只有一个生产者，可使用TryPushSingleProducer避免入队时的CAS操作
+template <typename T>
+class BoundedQueue {
+public:
+    // 容量会向上取整为2的幂
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // 尝试入队，队列已满时返回false
+    bool TryPush(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 单生产者入队：入队位置只由当前线程修改，无需CAS，队列已满时返回false
+    bool TryPushSingleProducer(T&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != pos) {
+            return false;
+        }
+        slot.value = std::move(value);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        enqueue_pos_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 尝试出队，队列为空时返回false
+    bool TryPop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 队列容量
+    size_t Capacity() const noexcept { return mask_ + 1; }
+
+    // 已入队元素的累计数量
+    size_t EnqueuePosition() const noexcept { return enqueue_pos_.load(std::memory_order_acquire); }
+
+    // 已出队元素的累计数量
+    size_t DequeuePosition() const noexcept { return dequeue_pos_.load(std::memory_order_acquire); }
+
+    // 队列中元素的近似数量
+    size_t ApproxSize() const noexcept {
+        size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_ASYNC_QUEUE_H_
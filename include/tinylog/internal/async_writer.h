@@ -0,0 +1,120 @@
+#ifndef TINYLOG_INTERNAL_ASYNC_WRITER_H_
+#define TINYLOG_INTERNAL_ASYNC_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tinylog/internal/async_queue.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/log_level.h"
+
+namespace tinylog::internal {
+
+// 生产者线程私有的日志通道：只有所属线程入队，后台线程出队
+struct ThreadLane {
+    explicit ThreadLane(size_t capacity) : queue(capacity) {}
+
+    BoundedQueue<LogEvent> queue;
+    // 后台线程已写完的出队位置，用于Flush判断
+    alignas(kCacheLineSize) std::atomic<size_t> completed_pos{0};
+    // 所属线程已退出，通道写空后即可回收
+    std::atomic<bool> closed{false};
+    // 所属写入器已销毁，线程侧的缓存可以丢弃该通道
+    std::atomic<bool> orphaned{false};
+
+    // 以下成员仅由后台线程访问：已出队、等待归并写出的队首日志，以及取出它之前的出队位置
+    LogEvent head;
+    size_t head_pos = 0;
+    std::atomic<bool> has_head{false};
+};
+
+// 异步写入器：每个生产者线程拥有独立的有界通道，由后台线程按各通道队首日志的时间戳多路归并，
+// 恢复跨线程的顺序后统一写入各个sink
+class AsyncWriter {
+public:
+    // queue_capacity为所有通道的总容量：按CPU核数均分为单个通道的容量上限，新通道从剩余容量中分配，
+    // 剩余容量不足时通道只保留最小容量，线程退出回收通道后归还
+    AsyncWriter(std::vector<std::shared_ptr<SinkInterface>> sinks, size_t queue_capacity, OverflowPolicy policy);
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+    AsyncWriter(AsyncWriter&&) = delete;
+    AsyncWriter& operator=(AsyncWriter&&) = delete;
+
+    // 将日志事件放入当前线程的通道，按溢出策略处理通道已满的情况；返回因此丢弃的日志数量
+    size_t Enqueue(LogEvent&& event);
+
+    // 等待调用前已入队的日志全部写入，然后刷新所有sink
+    void Flush();
+
+    // 崩溃处理中调用：取出各通道中剩余的日志，以CrashFormatEvent编码为文本后直接写入各sink的文件描述符。
+    // 后台线程正在写入的那条日志无法写出；没有文件描述符的sink（二进制文件、内存映射文件）不写入
+    void CrashDrain() noexcept;
+
+    // 获取因队列已满而丢弃的日志数量
+    uint64_t GetDroppedCount() const noexcept;
+
+    // 获取单个通道的最大积压数量：后台线程每轮取日志前采样，生产者遇到通道已满时记为通道容量
+    size_t GetQueueHighWater() const noexcept { return queue_high_water_.load(std::memory_order_relaxed); }
+
+private:
+    // 获取（必要时注册）当前线程的通道
+    ThreadLane& GetThreadLane();
+    // 后台线程主循环
+    void Run();
+    // 按时间戳归并各通道的日志并写入sink，返回处理的数量
+    size_t Drain();
+    // 从通道取出下一条日志作为队首，通道为空时返回false
+    static bool LoadHead(ThreadLane& lane);
+    // 唤醒可能处于休眠状态的后台线程
+    void WakeUp();
+    // 是否有通道中还有未出队的日志，后台线程休眠前检查
+    bool HasPendingEvents();
+    // 更新最大积压数量
+    void UpdateHighWater(size_t depth) noexcept;
+
+    // 为新通道从剩余容量中分配容量，需持有lanes_mutex_
+    size_t ReserveLaneCapacity();
+
+    const uint64_t id_;
+    const size_t total_capacity_;
+    // 单个通道的容量上限和剩余容量不足时的最小容量
+    const size_t lane_capacity_;
+    const size_t min_lane_capacity_;
+    OverflowPolicy policy_;
+    std::vector<std::shared_ptr<SinkInterface>> sinks_;
+
+    // 已注册的线程通道，注册和回收时加锁，后台线程仅在版本变化时复制
+    std::mutex lanes_mutex_;
+    std::vector<std::shared_ptr<ThreadLane>> lanes_;
+    std::atomic<uint64_t> lanes_version_{0};
+    // 已分配给各通道的容量总和，受lanes_mutex_保护
+    size_t reserved_capacity_ = 0;
+
+    // 以下成员仅由后台线程访问
+    std::vector<std::shared_ptr<ThreadLane>> active_lanes_;
+    uint64_t active_lanes_version_ = 0;
+    // 归并用的最小堆：各通道队首日志的时间戳及通道下标
+    std::vector<std::pair<int64_t, size_t>> merge_heap_;
+
+    std::atomic<uint64_t> dropped_count_{0};
+    std::atomic<size_t> queue_high_water_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+    std::atomic<bool> running_{true};
+    std::atomic<bool> sleeping_{false};
+    std::thread worker_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_ASYNC_WRITER_H_
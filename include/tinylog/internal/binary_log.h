@@ -0,0 +1,124 @@
+#ifndef TINYLOG_INTERNAL_BINARY_LOG_H_
+#define TINYLOG_INTERNAL_BINARY_LOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "tinylog/log_format.h"
+#include "tinylog/log_level.h"
+
+namespace tinylog::internal {
+
+struct LogEvent;
+
+// 二进制日志格式。varint为LEB128变长整数，字符串为varint长度加内容：
+//   文件头   "TLOGBIN" + 版本号（1字节），只出现在文件开头
+//   条目     类型（1字节）+ 内容
+//     kSession  无内容，此后调用点编号、模块编号和时间基准全部重新开始
+//     kSite     varint编号, 级别（1字节）, 标志（1字节，bit0表示有格式字符串）, 文件名, 函数名, varint行号, [格式字符串]
+//     kModule   varint编号, 模块名
+//     kRecord   varint调用点编号, varint模块编号（0表示全局日志，否则为编号加一）, zigzag varint时间差（纳秒）,
+//               varint长度 + 载荷（有格式字符串时为参数的二进制编码，否则为日志内容）
+namespace binary_log {
+
+inline constexpr char kMagic[] = {'T', 'L', 'O', 'G', 'B', 'I', 'N'};
+inline constexpr uint8_t kVersion = 1;
+inline constexpr size_t kHeaderSize = sizeof(kMagic) + 1;
+
+enum class EntryType : uint8_t { kSession = 1, kSite = 2, kModule = 3, kRecord = 4 };
+
+inline constexpr uint8_t kSiteHasFormat = 0x01;
+
+}  // namespace binary_log
+
+// 二进制日志编码器，非线程安全。
+// 调用点按描述符地址识别，不经过调用点描述符的日志按文件名、函数名和格式字符串的地址加行号和级别识别，
+// 这些字符串与异步模式下一样需要在程序运行期间保持有效；模块名按其在日志管理器中的存储地址识别
+class BinaryLogEncoder {
+public:
+    // 开始新的会话，清空调用点和模块表；with_header为true时先写文件头
+    void BeginSession(bool with_header, FormatBuffer& out);
+
+    // 将一条日志追加到out，本会话中首次出现的调用点和模块先写入其定义
+    void Encode(const LogEvent& event, FormatBuffer& out);
+
+private:
+    struct SiteKey {
+        const void* site;
+        const char* filename;
+        const char* function;
+        const char* format;
+        int line;
+        LogLevel level;
+
+        bool operator==(const SiteKey& other) const noexcept {
+            return site == other.site && filename == other.filename && function == other.function &&
+                   format == other.format && line == other.line && level == other.level;
+        }
+    };
+
+    struct SiteKeyHash {
+        size_t operator()(const SiteKey& key) const noexcept {
+            size_t hash = std::hash<const void*>()(key.site);
+            hash = hash * 31 + std::hash<const void*>()(key.filename);
+            hash = hash * 31 + std::hash<const void*>()(key.function);
+            hash = hash * 31 + std::hash<const void*>()(key.format);
+            return hash * 31 + static_cast<size_t>(key.line) * 8 + static_cast<size_t>(key.level);
+        }
+    };
+
+    uint64_t SiteId(const LogEvent& event, FormatBuffer& out);
+    uint64_t ModuleId(std::string_view module, FormatBuffer& out);
+
+    std::unordered_map<SiteKey, uint64_t, SiteKeyHash> sites_;
+    std::unordered_map<const char*, uint64_t> modules_;
+    int64_t last_timestamp_ = 0;
+};
+
+// 二进制日志解码器，逐条还原日志事件
+class BinaryLogReader {
+public:
+    explicit BinaryLogReader(std::istream& input) : input_(input) {}
+
+    // 读取下一条日志。event中的调用点描述符和字符串在下一次调用前有效。
+    // 读到文件末尾或数据损坏时返回false，后者可通过error()获取原因
+    bool Next(LogEvent& event);
+
+    // 数据损坏的原因，正常结束时为空
+    const std::string& error() const noexcept { return error_; }
+
+private:
+    struct DecodedSite {
+        std::string filename;
+        std::string function;
+        std::string format;
+        CallSite site;
+    };
+
+    bool ReadHeader();
+    bool ReadSite();
+    bool ReadModule();
+    bool ReadRecord(LogEvent& event);
+    bool ReadVarint(uint64_t& value);
+    bool ReadString(std::string& value);
+    bool Fail(const std::string& reason);
+
+    std::istream& input_;
+    bool header_read_ = false;
+    std::vector<std::unique_ptr<DecodedSite>> sites_;
+    std::vector<std::string> modules_;
+    int64_t last_timestamp_ = 0;
+    std::string payload_;
+    std::string error_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_BINARY_LOG_H_
@@ -0,0 +1,102 @@
+#ifndef TINYLOG_INTERNAL_CONFIG_WATCHER_H_
+#define TINYLOG_INTERNAL_CONFIG_WATCHER_H_
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace tinylog::internal {
+
+// 配置文件监控：所有通过配置文件创建的日志实例共用一个后台线程。
+// Linux下使用inotify监控配置文件所在的目录，文件写入完成或被替换（编辑器保存时常用rename）后立即回调；
+// inotify不可用时每隔kPollInterval检查一次文件状态
+class ConfigWatcher {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr std::chrono::milliseconds kPollInterval{200};
+
+    // 获取配置监控单例，单例不会被销毁，保证静态对象析构期间仍可取消监控
+    static ConfigWatcher& GetInstance();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+    ConfigWatcher(ConfigWatcher&&) = delete;
+    ConfigWatcher& operator=(ConfigWatcher&&) = delete;
+
+    // 开始监控文件，文件内容变化时在后台线程中调用callback，返回监控标识
+    uint64_t Watch(const std::string& file_path, Callback callback);
+
+    // 取消监控，不等待下一次检查；返回后callback不会再被调用（在callback中取消时除外）
+    void Unwatch(uint64_t id);
+
+    // 是否正在使用inotify（否则轮询文件状态）
+    bool IsUsingInotify() const noexcept { return inotify_fd_ >= 0; }
+
+private:
+    // 用于判断文件是否真的发生变化的文件状态
+    struct FileStamp {
+        ino_t inode = 0;
+        off_t size = -1;
+        int64_t mtime_ns = 0;
+
+        bool operator==(const FileStamp& other) const noexcept {
+            return inode == other.inode && size == other.size && mtime_ns == other.mtime_ns;
+        }
+        bool operator!=(const FileStamp& other) const noexcept { return !(*this == other); }
+    };
+
+    struct WatchEntry {
+        std::string directory;
+        std::string file_name;
+        std::string file_path;
+        int watch_descriptor = -1;
+        FileStamp stamp;
+        Callback callback;
+    };
+
+    ConfigWatcher();
+    ~ConfigWatcher() = default;
+
+    static FileStamp GetFileStamp(const std::string& file_path);
+
+    void Run();
+    // 读取inotify事件，标记受影响的监控项
+    void ReadEvents();
+    // 检查标记的监控项和轮询的监控项，对文件状态变化的监控项调用回调
+    void CheckWatches();
+    // 唤醒后台线程，使其重新计算等待时间
+    void WakeUp();
+
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;
+    std::map<uint64_t, WatchEntry> watches_;
+    // inotify事件涉及的监控项，等待检查
+    std::set<uint64_t> pending_;
+    // 未能加入inotify的监控项数量，这些监控项按kPollInterval轮询
+    size_t polled_count_ = 0;
+    // 各目录监控描述符的引用计数
+    std::map<int, int> descriptor_refs_;
+    uint64_t next_id_ = 1;
+
+    // 正在执行回调的监控项，Unwatch据此等待回调结束
+    uint64_t running_id_ = 0;
+    std::thread::id worker_id_;
+    bool started_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable poll_cv_;
+    std::condition_variable callback_cv_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_CONFIG_WATCHER_H_
@@ -0,0 +1,56 @@
+#ifndef TINYLOG_INTERNAL_CRASH_HANDLER_H_
+#define TINYLOG_INTERNAL_CRASH_HANDLER_H_
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+
+namespace tinylog::internal {
+
+class AsyncWriter;
+class SinkInterface;
+struct LogEvent;
+
+// 崩溃处理：进程收到SIGSEGV、SIGABRT、SIGBUS信号时，在信号处理函数中把各文件sink缓冲区和异步队列中
+// 尚未写出的日志以write(2)直接写入文件描述符，追加调用栈后按原有的处理方式重新触发信号。
+// 记录kFatal日志时进程状态仍然正常，按正常路径等待异步队列写完并刷新，追加调用栈后abort。
+// 需要写出的sink和异步写入器在构造时登记、析构时注销，日志记录路径没有额外开销。
+// 信号处理函数在备用栈上执行，栈溢出导致的SIGSEGV也能处理。备用栈按线程安装：调用InstallCrashHandler的线程、
+// 安装之后记录过日志的线程和异步写入线程各有一个，其余线程崩溃时仍在原栈上处理，栈溢出时无法写出日志
+
+// 登记和注销。崩溃处理开始后其他线程的注销会一直阻塞，保证崩溃处理期间访问的对象不会被释放
+void RegisterCrashSink(SinkInterface* sink) noexcept;
+void UnregisterCrashSink(SinkInterface* sink) noexcept;
+void RegisterCrashWriter(AsyncWriter* writer) noexcept;
+void UnregisterCrashWriter(AsyncWriter* writer) noexcept;
+
+// 安装信号处理函数并使kFatal日志触发崩溃处理，重复调用时只为当前线程安装备用栈
+void InstallCrashHandler();
+
+// 已安装崩溃处理时为当前线程安装备用栈，每个线程只安装一次，线程退出时释放。日志记录路径上调用
+void PrepareCrashThread() noexcept;
+
+// 记录kFatal日志后调用：已安装崩溃处理时写出所有日志和调用栈后abort，否则直接返回
+void HandleFatal();
+
+// 以下函数供sink和异步写入器在崩溃处理中使用，只使用异步信号安全的操作，不分配内存
+
+// 尝试获取锁。持有者可能是崩溃的线程本身，短暂等待后仍未获取时返回false
+bool CrashTryLock(std::mutex& mutex) noexcept;
+
+// 以write(2)写出全部数据，offset不为负数时以pwrite(2)写入指定偏移量
+void CrashWrite(int fd, const char* data, size_t size, off_t offset = -1) noexcept;
+
+// sink在崩溃处理中可以追加文本的文件描述符，没有时为-1。每个sink首次查询时调用其crashFlush写出缓冲区
+int CrashSinkFd(SinkInterface& sink) noexcept;
+
+// 把日志事件编码为一行文本，格式为"[秒.纳秒] [级别] [模块] 文件:函数:行号 - 内容 键=值"。
+// 不使用格式化器（其线程局部缓存、localtime_r和区域设置都不是异步信号安全的），结果写在静态存储中，
+// 下次调用时被覆盖，过长的日志被截断
+std::string_view CrashFormatEvent(const LogEvent& event) noexcept;
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_CRASH_HANDLER_H_
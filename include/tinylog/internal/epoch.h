@@ -0,0 +1,68 @@
+#ifndef TINYLOG_INTERNAL_EPOCH_H_
+#define TINYLOG_INTERNAL_EPOCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "tinylog/internal/async_queue.h"
+
+namespace tinylog::internal {
+
+// 读多写少数据的回收同步：读取方进入和离开时各修改一次计数器，不加锁也不会阻塞；
+// 写入方发布新数据后调用Synchronize，等待此前进入的读取方全部离开后才能释放旧数据。
+// 读取方按纪元的奇偶计数，写入方等待时新进入的读取方计入另一个计数器，持续的读取不会使写入方一直等待
+class EpochDomain {
+public:
+    EpochDomain() = default;
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // 进入读取区，返回值需传给Leave
+    size_t Enter() noexcept {
+        size_t index = static_cast<size_t>(epoch_.load(std::memory_order_seq_cst) & 1);
+        readers_[index].count.fetch_add(1, std::memory_order_seq_cst);
+        return index;
+    }
+
+    // 离开读取区
+    void Leave(size_t index) noexcept { readers_[index].count.fetch_sub(1, std::memory_order_release); }
+
+    // 等待调用前进入的读取方全部离开，多个写入方需由调用方串行化
+    void Synchronize() noexcept;
+
+private:
+    struct alignas(kCacheLineSize) ReaderCount {
+        std::atomic<int64_t> count{0};
+    };
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> epoch_{0};
+    ReaderCount readers_[2];
+};
+
+// 读取区守卫，析构时离开读取区
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain& domain) noexcept : domain_(&domain), index_(domain.Enter()) {}
+    ~EpochGuard() { Release(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+    // 提前离开读取区
+    void Release() noexcept {
+        if (domain_ != nullptr) {
+            domain_->Leave(index_);
+            domain_ = nullptr;
+        }
+    }
+
+private:
+    EpochDomain* domain_;
+    size_t index_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_EPOCH_H_
@@ -0,0 +1,46 @@
+#ifndef TINYLOG_INTERNAL_FILE_ROTATION_H_
+#define TINYLOG_INTERNAL_FILE_ROTATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "tinylog/log_level.h"
+
+namespace tinylog::internal {
+
+// 滚动策略：何时滚动、保留多少备份以及是否压缩
+struct RotationPolicy {
+    RotationMode mode = RotationMode::kSize;
+    int32_t max_file_count = 5;         // 保留的备份文件数量
+    size_t max_file_size = 1024 * 1024;  // 单个文件大小上限，按时间滚动时同样生效
+    size_t max_total_size = 0;          // 当前文件与备份文件的总大小上限，0表示不限制
+    bool compress = false;              // 是否将备份文件压缩为gzip格式
+};
+
+// 按时间滚动的时间段
+struct RotationPeriod {
+    std::string label;           // 时间段标签，用于备份文件名（按天为YYYYMMDD，按小时为YYYYMMDD-HH）
+    int64_t end_ns = INT64_MAX;  // 下一个时间段的开始时间（纳秒），按大小滚动时为INT64_MAX
+};
+
+// 计算包含指定时间的时间段，使用本地时区
+RotationPeriod GetRotationPeriod(RotationMode mode, int64_t timestamp_ns);
+
+// 是否支持压缩备份文件（编译时找到zlib）
+bool IsCompressionSupported();
+
+// 将文件压缩为gzip格式，成功后删除原文件
+bool CompressFile(const std::string& source_file, const std::string& target_file);
+
+// 归档滚动出的文件：改名为备份文件名，按需压缩，再按数量和总大小删除最旧的备份。
+// 涉及目录操作和压缩，只在维护线程上调用
+void ArchiveRotatedFile(const std::string& file_path, const std::string& pending_file,
+                        const std::string& period_label, const RotationPolicy& policy);
+
+// 按数量和总大小删除最旧的备份文件
+void EnforceRetention(const std::string& file_path, const RotationPolicy& policy);
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_FILE_ROTATION_H_
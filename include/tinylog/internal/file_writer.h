@@ -0,0 +1,72 @@
+#ifndef TINYLOG_INTERNAL_FILE_WRITER_H_
+#define TINYLOG_INTERNAL_FILE_WRITER_H_
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "tinylog/log_level.h"
+
+namespace tinylog::internal {
+
+// 日志文件的底层写入方式，由FileSink在持有文件锁时调用
+class FileWriter {
+public:
+    FileWriter() = default;
+    virtual ~FileWriter() = default;
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    // 打开日志文件时使用的标志
+    virtual int openFlags() const = 0;
+
+    // 将buffer和extra依次写入fd的offset处，返回时buffer已被清空（可能换成另一块缓冲区），
+    // extra无需在返回后保持有效。异步实现可以在数据落盘前返回
+    virtual void write(int fd, std::vector<char>& buffer, std::string_view extra, size_t offset) = 0;
+
+    // 等待已提交的写入全部完成，关闭文件描述符前必须调用
+    virtual void wait() {}
+};
+
+// 同步写入：以追加方式打开文件，每批数据一次writev
+class WritevFileWriter : public FileWriter {
+public:
+    int openFlags() const override;
+    void write(int fd, std::vector<char>& buffer, std::string_view extra, size_t offset) override;
+};
+
+// io_uring异步写入：按文件偏移量提交写入请求，最多同时保持kQueueDepth块缓冲区在途，
+// 后台线程只在所有缓冲区都在途时才等待磁盘。编译时未找到liburing或运行时无法创建io_uring时退化为pwritev
+class UringFileWriter : public FileWriter {
+public:
+    static constexpr unsigned kQueueDepth = 4;
+
+    explicit UringFileWriter(size_t buffer_size);
+    ~UringFileWriter() override;
+
+    int openFlags() const override;
+    void write(int fd, std::vector<char>& buffer, std::string_view extra, size_t offset) override;
+    void wait() override;
+
+    // 是否正在使用io_uring（否则使用pwritev）
+    bool isUringActive() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// 写满iov中的全部数据，offset为负数时写入当前文件位置，否则写入指定偏移量
+bool WriteFully(int fd, struct iovec* iov, int count, off_t offset);
+
+// 按写入方式创建文件写入器，kMmap由MmapFileSink处理，此处按缓冲写入处理
+std::unique_ptr<FileWriter> CreateFileWriter(FileEngine engine, size_t buffer_size);
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_FILE_WRITER_H_
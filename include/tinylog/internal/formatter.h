@@ -0,0 +1,54 @@
+#ifndef TINYLOG_INTERNAL_FORMATTER_H_
+#define TINYLOG_INTERNAL_FORMATTER_H_
+
+#include "tinylog/log_format.h"
+#include "tinylog/log_level.h"
+
+namespace tinylog::internal {
+
+struct LogEvent;
+
+// 日志格式化器，负责把日志事件转换为写入sink的字节。
+// 多个sink共享同一个格式化器实例时，每条日志只会被格式化一次
+class Formatter {
+public:
+    Formatter() = default;
+    virtual ~Formatter() = default;
+
+    Formatter(const Formatter&) = delete;
+    Formatter& operator=(const Formatter&) = delete;
+
+    // 将日志事件格式化后写入out（out原有内容会被覆盖，其容量可以复用）
+    virtual void format(const LogEvent& event, FormatBuffer& out) const = 0;
+};
+
+// 文本格式化器：[时间戳] [级别] [模块名] 文件名:函数名:行号 - 日志内容 key=value...，
+// 全局日志省略模块名，结构化字段依次追加在日志内容之后
+class TextFormatter : public Formatter {
+public:
+    explicit TextFormatter(TimestampPrecision precision = TimestampPrecision::kMilliseconds)
+        : timestamp_precision_(precision) {}
+
+    void format(const LogEvent& event, FormatBuffer& out) const override;
+
+private:
+    TimestampPrecision timestamp_precision_;
+};
+
+// JSON Lines格式化器：每条日志输出一行JSON对象，
+// {"ts":"...","level":"INFO","module":"net","file":"...","func":"...","line":12,"msg":"...",字段...}，
+// 全局日志省略module，结构化字段按类型输出为JSON字符串、数值或布尔值，与固定键同名时不做去重
+class JsonFormatter : public Formatter {
+public:
+    explicit JsonFormatter(TimestampPrecision precision = TimestampPrecision::kMilliseconds)
+        : timestamp_precision_(precision) {}
+
+    void format(const LogEvent& event, FormatBuffer& out) const override;
+
+private:
+    TimestampPrecision timestamp_precision_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_FORMATTER_H_
@@ -0,0 +1,28 @@
+#ifndef TINYLOG_INTERNAL_JSON_H_
+#define TINYLOG_INTERNAL_JSON_H_
+
+#include <cstddef>
+#include <string_view>
+
+#include "tinylog/log_format.h"
+
+namespace tinylog::internal {
+
+// 查找str中从start开始第一个需要转义的字节（引号、反斜杠或小于0x20的控制字符），没有时返回str.size()。
+// x86下使用SSE2每次检查16个字节
+size_t FindJsonEscape(std::string_view str, size_t start) noexcept;
+
+// 将str按JSON字符串的规则转义后追加到out（不含两侧引号）。
+// 其余字节（包括UTF-8多字节序列）原样复制，不会校验UTF-8的合法性
+void AppendJsonEscaped(std::string_view str, FormatBuffer& out);
+
+// 追加带引号的JSON字符串
+inline void AppendJsonString(std::string_view str, FormatBuffer& out) {
+    out.Append('"');
+    AppendJsonEscaped(str, out);
+    out.Append('"');
+}
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_JSON_H_
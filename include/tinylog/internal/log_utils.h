@@ -1,14 +1,30 @@
 #ifndef TINYLOG_INTERNAL_LOG_UTILS_H_
 #define TINYLOG_INTERNAL_LOG_UTILS_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <string>
 
 #include "tinylog/log_level.h"
 
 namespace tinylog::internal {
 
-// 获取当前时间戳，格式为YYYY-MM-DD HH:MM:SS
-std::string GetCurrentTimestamp();
+// 时间戳格式化结果的最大长度（YYYY-MM-DD HH:MM:SS.uuuuuu）
+constexpr size_t kMaxTimestampLength = 32;
+
+// 获取当前时间，单位为自Unix纪元起的纳秒数
+int64_t GetCurrentTimeNanos();
+
+// 使用指定时钟获取当前时间，单位为自Unix纪元起的纳秒数
+int64_t GetCurrentTimeNanos(ClockSource source);
+
+// 初始化指定时钟（如TSC频率校准），应在日志热路径之外调用
+void InitClockSource(ClockSource source);
+
+// 将纳秒时间戳格式化为YYYY-MM-DD HH:MM:SS[.mmm|.uuuuuu]，返回写入的长度。
+// 每个线程缓存当前秒的日期时间前缀，同一秒内只需填充亚秒部分
+size_t FormatTimestamp(int64_t timestamp_ns, TimestampPrecision precision, char* buffer);
 
 // 将日志级别转换为字符串
 const char* LogLevelToString(LogLevel level);
@@ -22,6 +38,42 @@ std::string LogSinkToString(LogSink sink);
 // 将字符串转换为日志输出目标
 LogSink StringToLogSink(const std::string& sink_str);
 
+// 将异步队列溢出策略转换为字符串
+std::string OverflowPolicyToString(OverflowPolicy policy);
+
+// 将字符串转换为异步队列溢出策略
+OverflowPolicy StringToOverflowPolicy(const std::string& policy_str);
+
+// 将时间戳精度转换为字符串
+std::string TimestampPrecisionToString(TimestampPrecision precision);
+
+// 将字符串转换为时间戳精度
+TimestampPrecision StringToTimestampPrecision(const std::string& precision_str);
+
+// 将时钟类型转换为字符串
+std::string ClockSourceToString(ClockSource source);
+
+// 将字符串转换为时钟类型
+ClockSource StringToClockSource(const std::string& source_str);
+
+// 将文件滚动方式转换为字符串
+std::string RotationModeToString(RotationMode mode);
+
+// 将字符串转换为文件滚动方式
+RotationMode StringToRotationMode(const std::string& mode_str);
+
+// 将文件写入方式转换为字符串
+std::string FileEngineToString(FileEngine engine);
+
+// 将字符串转换为文件写入方式
+FileEngine StringToFileEngine(const std::string& engine_str);
+
+// 将日志输出格式转换为字符串
+std::string LogLayoutToString(LogLayout layout);
+
+// 将字符串转换为日志输出格式
+LogLayout StringToLogLayout(const std::string& layout_str);
+
 // 去除字符串首尾的空格和制表符
 void Trim(std::string& str);
 
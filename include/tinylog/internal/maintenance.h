@@ -0,0 +1,88 @@
+#ifndef TINYLOG_INTERNAL_MAINTENANCE_H_
+#define TINYLOG_INTERNAL_MAINTENANCE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace tinylog::internal {
+
+// 后台维护线程：执行文件重命名、压缩、删除等耗时操作以及定时任务，日志写入路径只负责投递任务。
+// 所有sink共用一个低优先级线程，任务按投递顺序依次执行，到期的定时任务在两个任务之间执行
+class MaintenanceWorker {
+public:
+    // 获取维护线程单例，单例不会被销毁，保证静态对象析构期间仍可投递任务
+    static MaintenanceWorker& GetInstance();
+
+    MaintenanceWorker(const MaintenanceWorker&) = delete;
+    MaintenanceWorker& operator=(const MaintenanceWorker&) = delete;
+    MaintenanceWorker(MaintenanceWorker&&) = delete;
+    MaintenanceWorker& operator=(MaintenanceWorker&&) = delete;
+
+    // 投递任务，立即返回
+    void Post(std::function<void()> task);
+
+    // 登记每隔interval执行一次的定时任务，返回注销用的编号
+    uint64_t AddTimer(std::chrono::milliseconds interval, std::function<void()> task);
+
+    // 注销定时任务，任务正在执行时等待其结束，返回后不会再执行。不能在定时任务中调用
+    void RemoveTimer(uint64_t id);
+
+private:
+    struct Timer {
+        uint64_t id;
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point due;
+        std::function<void()> task;
+    };
+
+    MaintenanceWorker();
+    ~MaintenanceWorker() = default;
+
+    void Run();
+    // 执行到期的定时任务，返回最早的下次到期时间；调用方持有lock，执行任务期间释放
+    std::chrono::steady_clock::time_point RunDueTimers(std::unique_lock<std::mutex>& lock);
+
+    std::deque<std::function<void()>> tasks_;
+    std::vector<Timer> timers_;
+    uint64_t next_timer_id_ = 1;
+    uint64_t running_timer_ = 0;  // 正在执行的定时任务，0表示没有
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable timer_cv_;
+};
+
+// 一个sink投递到维护线程的任务：记录尚未完成的数量，sink销毁或复用任务引用的资源前只等待自己的任务，
+// 不受其他sink的滚动和压缩影响。析构时等待全部任务完成
+class MaintenanceTasks {
+public:
+    MaintenanceTasks() = default;
+    ~MaintenanceTasks() { Wait(); }
+
+    MaintenanceTasks(const MaintenanceTasks&) = delete;
+    MaintenanceTasks& operator=(const MaintenanceTasks&) = delete;
+    MaintenanceTasks(MaintenanceTasks&&) = delete;
+    MaintenanceTasks& operator=(MaintenanceTasks&&) = delete;
+
+    // 投递任务到维护线程，立即返回
+    void Post(std::function<void()> task);
+
+    // 等待本对象投递的任务全部执行完成，调用方不能持有任务需要的锁
+    void Wait();
+
+private:
+    void Finish();
+
+    size_t pending_ = 0;
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_MAINTENANCE_H_
@@ -1,22 +1,45 @@
 #ifndef TINYLOG_INTERNAL_SINK_INTERFACE_H_
 #define TINYLOG_INTERNAL_SINK_INTERFACE_H_
 
-#include <ctime>
-#include <fstream>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "tinylog/internal/async_queue.h"
+#include "tinylog/internal/binary_log.h"
+#include "tinylog/internal/file_rotation.h"
+#include "tinylog/internal/file_writer.h"
+#include "tinylog/internal/formatter.h"
+#include "tinylog/internal/maintenance.h"
+#include "tinylog/log_format.h"
 #include "tinylog/log_level.h"
+#include "tinylog/log_stats.h"
 
 namespace tinylog::internal {
 
 struct LogEvent {
     std::string message;   // 日志内容
     LogLevel level;        // 日志级别
-    time_t timestamp;      // 时间戳（格式：YYYY-MM-DD HH:MM:SS）
+    int64_t timestamp;     // 捕获时间（自Unix纪元起的纳秒数）
     const char* filename;  // 触发日志的文件名
     const char* function;  // 触发日志的函数名
     int line = 0;          // 触发日志的行号
+    const char* format = nullptr;    // 延迟格式化的格式字符串，为空时直接使用message
+    ArgBuffer args;                  // 延迟格式化的二进制参数
+    const CallSite* site = nullptr;  // 日志宏生成的调用点描述符，非空时位置信息和格式字符串取自该描述符
+    std::string_view module;         // 模块名，全局日志为空
+
+    const char* Filename() const noexcept { return site != nullptr ? site->filename : filename; }
+    const char* Function() const noexcept { return site != nullptr ? site->function : function; }
+    int Line() const noexcept { return site != nullptr ? site->line : line; }
+    const char* Format() const noexcept { return site != nullptr ? site->format : format; }
 };
 
 class SinkInterface {
@@ -29,48 +52,222 @@ public:
     SinkInterface(SinkInterface&&) = default;
     SinkInterface& operator=(SinkInterface&&) = default;
 
-    // 处理日志事件，会调用format和write方法
+    // 处理日志事件，会调用格式化器和write方法
     void log(const LogEvent& event);
     // 刷新日志缓存
     virtual void flush() {}
 
+    // 崩溃处理中调用（见crash_handler.h），只能使用异步信号安全的操作：将缓冲区中尚未写出的内容直接写入
+    // 文件描述符，返回之后可以用write(2)追加文本日志和调用栈的文件描述符，没有时返回-1
+    virtual int crashFlush() noexcept { return -1; }
+
+    // 设置格式化器，使用相同格式化器实例的sink共享同一份格式化结果；
+    // 没有格式化器的sink（如二进制文件sink）直接通过writeEvent接收日志事件
+    void setFormatter(std::shared_ptr<const Formatter> formatter) { formatter_ = std::move(formatter); }
+    // 获取格式化器
+    const Formatter* formatter() const noexcept { return formatter_.get(); }
+
+    // 将日志事件分发给多个sink，每个不同的格式化器只格式化一次，格式化结果写入线程私有的可复用缓冲区
+    static void dispatch(const LogEvent& event, const std::vector<std::shared_ptr<SinkInterface>>& sinks);
+
+    // 汇总本sink的统计，输出目标由调用方填写
+    void collectStats(SinkStats& stats) const;
+
 protected:
-    // 写入格式化后的日志消息，子类必须实现
-    virtual void write(const std::string& message) = 0;
+    // 写入格式化后的日志消息，子类必须实现；level用于按级别决定是否立即刷新
+    virtual void write(std::string_view message, LogLevel level) = 0;
+    // 不经格式化直接写入日志事件，仅在没有格式化器时调用
+    virtual void writeEvent(const LogEvent& event) {}
+
+    // 以下统计方法不加锁，可在任意线程调用
+    void recordWrite(size_t bytes) noexcept { counters_.Add(kBytesWritten, bytes); }
+    void recordWriteCall() noexcept { counters_.Add(kWriteCalls); }
+    void recordRotation() noexcept { counters_.Add(kRotations); }
+    void recordDrop() noexcept { counters_.Add(kDropped); }
+    // 记录一次刷新的耗时，start_ns为开始时的MonotonicNanos()
+    void recordFlush(int64_t start_ns) noexcept;
+    // 用于计算刷新耗时的单调时钟
+    static int64_t MonotonicNanos() noexcept;
 
 private:
-    // 格式化日志事件
-    std::string format(const LogEvent& event);
+    enum StatsCounter : size_t { kBytesWritten, kWriteCalls, kRotations, kDropped, kStatsCounterCount };
+
+    std::shared_ptr<const Formatter> formatter_ = std::make_shared<TextFormatter>();
+    StripedCounters<kStatsCounterCount> counters_;
+    std::array<std::atomic<uint64_t>, kFlushLatencyBuckets> flush_latency_{};
+};
+
+// 刷新策略：缓冲区写满、距上次刷新超过指定时间、日志级别达到阈值或显式调用flush时刷新
+struct FlushPolicy {
+    size_t buffer_size = 64 * 1024;          // 用户态缓冲区大小，0表示不缓冲
+    int64_t interval_ms = 1000;              // 刷新间隔，0表示不按时间刷新
+    LogLevel flush_level = LogLevel::kError;  // 达到该级别的日志立即刷新
 };
 
 class ConsoleSink : public SinkInterface {
+public:
+    explicit ConsoleSink(LogLevel flush_level = LogLevel::kError) : flush_level_(flush_level) {}
+
+    void flush() override;
+    // stdio缓冲区由崩溃处理统一刷新，此处只返回标准输出
+    int crashFlush() noexcept override;
+
 protected:
-    void write(const std::string& message) override;
+    void write(std::string_view message, LogLevel level) override;
+
+private:
+    LogLevel flush_level_;
 };
 
 class FileSink : public SinkInterface {
 public:
-    explicit FileSink(const std::string& file_path, int32_t max_file_count = 5, size_t max_file_size = 1024 * 1024);
+    explicit FileSink(const std::string& file_path, int32_t max_file_count = 5, size_t max_file_size = 1024 * 1024,
+                      const FlushPolicy& flush_policy = FlushPolicy());
+    FileSink(const std::string& file_path, const RotationPolicy& rotation_policy,
+             const FlushPolicy& flush_policy = FlushPolicy(), FileEngine engine = FileEngine::kBuffered);
     ~FileSink() override;
 
     FileSink(const FileSink&) = delete;
     FileSink& operator=(const FileSink&) = delete;
-    FileSink(FileSink&&) noexcept = default;
-    FileSink& operator=(FileSink&&) noexcept = default;
+    FileSink(FileSink&&) = delete;
+    FileSink& operator=(FileSink&&) = delete;
 
-protected:
-    void write(const std::string& message) override;
     void flush() override;
+    int crashFlush() noexcept override;
+
+protected:
+    void write(std::string_view message, LogLevel level) override;
+
+    // 以下方法调用方需持有file_mutex_
+    // 按需打开或滚动文件，返回当前是否有可写入的文件
+    bool prepareFile();
+    // 将数据追加到缓冲区，并按刷新策略写入文件
+    void append(std::string_view data, LogLevel level);
+    // 当前文件的序号，每打开一个文件（包括滚动后的新文件）加一
+    uint64_t fileGeneration() const noexcept { return file_generation_; }
+    // 当前文件大小，包含缓冲区中尚未写入的部分
+    size_t fileSize() const noexcept { return file_size_; }
+
+    std::mutex file_mutex_;
 
 private:
+    // 以下方法调用方需持有file_mutex_
+    bool openFile();
+    void closeFile();
+    void flushBuffer();
     void rotateFile();
-    bool shouldRotateFile() const;
+    bool shouldRotateFile();
+
+    // 由维护线程定时调用：距上次刷新超过刷新间隔时写出缓冲区，应用空闲时缓冲的日志也能按时落盘
+    void flushOnTimer();
+
+    std::string file_path_;
+    RotationPolicy rotation_policy_;
+    FlushPolicy flush_policy_;
+    std::unique_ptr<FileWriter> writer_;
+    // 当前文件所属的时间段，按大小滚动时不使用
+    RotationPeriod period_;
+
+    int fd_ = -1;
+    // 当前文件大小，包含缓冲区中尚未写入的部分，避免每条日志都查询文件大小
+    size_t file_size_ = 0;
+    std::vector<char> buffer_;
+    int64_t last_flush_ns_ = 0;
+    // 维护线程上的定时刷新任务，0表示没有
+    uint64_t flush_timer_ = 0;
+    // 投递到维护线程的滚动任务
+    MaintenanceTasks maintenance_;
+    uint64_t file_generation_ = 0;
+};
+
+// 二进制文件sink：日志不做文本格式化，按紧凑的二进制格式写入文件，由tinylog-decode离线还原为文本。
+// 每个文件（包括滚动后的新文件和重启后续写的文件）以会话标记开始，调用点和模块名在本会话首次出现时写入一次，
+// 之后的日志只写调用点编号、与上一条日志的时间差（zigzag变长整数）和参数的原始字节，格式见binary_log.h。
+// 滚动、缓冲和刷新策略与FileSink相同
+class BinaryFileSink : public FileSink {
+public:
+    BinaryFileSink(const std::string& file_path, const RotationPolicy& rotation_policy,
+                   const FlushPolicy& flush_policy = FlushPolicy(), FileEngine engine = FileEngine::kBuffered);
+    ~BinaryFileSink() override;
+
+    BinaryFileSink(const BinaryFileSink&) = delete;
+    BinaryFileSink& operator=(const BinaryFileSink&) = delete;
+    BinaryFileSink(BinaryFileSink&&) = delete;
+    BinaryFileSink& operator=(BinaryFileSink&&) = delete;
+
+    // 写出已编码的缓冲区，文本不能追加到二进制文件中，因此返回-1
+    int crashFlush() noexcept override;
+
+protected:
+    void writeEvent(const LogEvent& event) override;
+
+private:
+    // 以下成员由file_mutex_保护
+    BinaryLogEncoder encoder_;
+    uint64_t encoded_generation_ = 0;
+};
+
+// 内存映射日志文件的一个分段，对应一个预分配并映射的文件
+struct MmapSegment {
+    alignas(kCacheLineSize) std::atomic<size_t> reserved{0};  // 下一条日志的预留位置
+    alignas(kCacheLineSize) std::atomic<size_t> committed{0};  // 本次映射以来已写完的字节数
+    std::atomic<int32_t> writers{0};                          // 正在该分段上写入的线程数
+    std::atomic<int64_t> period_end_ns{INT64_MAX};            // 按时间滚动时所属时间段的结束时间
+    std::atomic<bool> retiring{false};                        // 等待解除映射，完成前不能复用
+    std::atomic<bool> unmap_claimed{false};                   // 回收时已有线程开始解除映射
+    char* data = nullptr;
+    size_t capacity = 0;  // 映射长度
+    size_t start = 0;     // 映射前文件中已有内容的长度
+    int fd = -1;
+    std::string period_label;
+};
+
+// 内存映射文件sink：预分配日志文件并映射到内存，写入线程通过原子操作预留位置后直接复制日志内容，
+// 无需加锁也无需每条日志一次系统调用。分段写满后映射新的分段，旧分段在后台截断到实际长度。
+// 写入的内容位于页缓存中，进程崩溃时不会丢失，但分段回收前文件末尾包含预分配的空字节。
+// 映射失败时丢弃日志并计入统计，之后的写入每隔一段时间重新尝试映射，不阻塞写入线程
+class MmapFileSink : public SinkInterface {
+public:
+    MmapFileSink(const std::string& file_path, const RotationPolicy& rotation_policy);
+    ~MmapFileSink() override;
+
+    MmapFileSink(const MmapFileSink&) = delete;
+    MmapFileSink& operator=(const MmapFileSink&) = delete;
+    MmapFileSink(MmapFileSink&&) = delete;
+    MmapFileSink& operator=(MmapFileSink&&) = delete;
+
+    void flush() override;
+
+protected:
+    void write(std::string_view message, LogLevel level) override;
+
+private:
+    // 分段对象循环复用而不释放，持有旧分段指针的写入线程不会访问已释放的内存
+    static constexpr size_t kSegmentSlots = 4;
+
+    // 调用方需持有rotate_mutex_
+    bool mapSegment(MmapSegment& segment, size_t min_capacity);
+    // 分段写满或时间段结束时切换分段，内部获取rotate_mutex_
+    void rotateSegment(MmapSegment* full, size_t required);
+    // 映射失败后没有当前分段时重新映射，距上次失败不足重试间隔时直接返回false，内部获取rotate_mutex_
+    bool remapSegment(size_t required);
+
+    // 等待分段上的写入线程退出后解除映射并截断文件
+    static void unmapSegment(MmapSegment& segment);
+    // 回收等待解除映射的分段：由维护线程和需要复用该分段的写入线程中先到的一方解除映射，
+    // 另一方等待其完成。写入线程因此只等待解除映射本身，不必等待排在前面的压缩等维护任务
+    static void releaseSegment(MmapSegment& segment);
 
     std::string file_path_;
-    int32_t max_file_count_;
-    size_t max_file_size_;
-    mutable std::ofstream log_file_;
-    mutable std::mutex file_mutex_;
+    RotationPolicy rotation_policy_;
+    MmapSegment segments_[kSegmentSlots];
+    std::atomic<MmapSegment*> current_{nullptr};
+    size_t next_slot_ = 0;
+    std::atomic<int64_t> next_remap_ns_{0};  // 映射失败后允许再次尝试的时间（MonotonicNanos）
+    std::atomic<uint64_t> unmapped_drops_{0};  // 本次映射失败以来丢弃的日志数量
+    std::mutex rotate_mutex_;
+    // 投递到维护线程的分段回收任务，析构时最先等待其完成
+    MaintenanceTasks maintenance_;
 };
 
 }  // namespace tinylog::internal
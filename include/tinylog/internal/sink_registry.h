@@ -0,0 +1,72 @@
+#ifndef TINYLOG_INTERNAL_SINK_REGISTRY_H_
+#define TINYLOG_INTERNAL_SINK_REGISTRY_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "tinylog/internal/async_writer.h"
+#include "tinylog/internal/formatter.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/log_config.h"
+
+namespace tinylog::internal {
+
+// sink注册表：按输出目标（控制台、文件的绝对路径）共享sink实例，
+// 指向同一文件的多个日志实例共用一个文件描述符、一个缓冲区和一套滚动状态。
+// 同一目标已打开时参数（写入方式、滚动、刷新策略、时间戳精度、输出格式）不一致的请求仍得到已有的sink并输出警告，
+// 同一目标任何时候只有一个sink；新参数在已有sink关闭后再次获取时生效。
+// 注册表只持有弱引用，sink在最后一个使用者释放后关闭
+class SinkRegistry {
+public:
+    // 获取sink注册表单例，单例不会被销毁，保证静态对象析构期间仍可使用
+    static SinkRegistry& GetInstance();
+
+    SinkRegistry(const SinkRegistry&) = delete;
+    SinkRegistry& operator=(const SinkRegistry&) = delete;
+    SinkRegistry(SinkRegistry&&) = delete;
+    SinkRegistry& operator=(SinkRegistry&&) = delete;
+
+    // 按日志配置获取所有输出目标的sink
+    std::vector<std::shared_ptr<SinkInterface>> AcquireSinks(const LogConfig& config);
+
+    // 从current切换到next时是否有输出目标不变但参数改变的sink，这类sink不能与替换它的新sink同时打开
+    bool ReplacesSinks(const LogConfig& current, const LogConfig& next) const;
+
+    // 获取写入同一组sink的异步写入器，sink、队列容量和溢出策略都相同的日志实例共用一个后台线程
+    std::shared_ptr<AsyncWriter> AcquireAsyncWriter(const std::vector<std::shared_ptr<SinkInterface>>& sinks,
+                                                    size_t queue_capacity, OverflowPolicy policy);
+
+    // 汇总当前打开的所有sink的统计，按输出目标排序
+    std::vector<SinkStats> CollectStats();
+
+private:
+    struct SinkEntry {
+        std::weak_ptr<SinkInterface> sink;
+        std::string settings;  // 创建参数，参数相同时才能共享
+    };
+
+    SinkRegistry() = default;
+    ~SinkRegistry() = default;
+
+    // 以下方法调用方需持有mutex_
+    std::shared_ptr<SinkInterface> AcquireSink(const std::string& destination, const std::string& settings,
+                                               const std::function<std::shared_ptr<SinkInterface>()>& create);
+    std::shared_ptr<const Formatter> GetFormatter(LogLayout layout, TimestampPrecision precision);
+    void RemoveExpired();
+
+    std::unordered_map<std::string, SinkEntry> sinks_;
+    std::unordered_map<std::string, std::weak_ptr<AsyncWriter>> async_writers_;
+    // 按输出格式和时间戳精度缓存的格式化器，共享格式化器的sink每条日志只格式化一次
+    static constexpr int kFormatterStride = 16;
+    std::unordered_map<int, std::shared_ptr<const Formatter>> formatters_;
+    std::mutex mutex_;
+};
+
+}  // namespace tinylog::internal
+
+#endif  // TINYLOG_INTERNAL_SINK_REGISTRY_H_
@@ -1,6 +1,8 @@
 #ifndef TINYLOG_LOG_CONFIG_H_
 #define TINYLOG_LOG_CONFIG_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include "log_level.h"
 
@@ -48,6 +50,79 @@ public:
     // 获取是否为异步模式
     bool IsAsyncMode() const noexcept;
 
+    // 设置异步队列总容量（由各生产者线程的通道分摊；线程过多、容量分完时每个通道仍保留最多256条）
+    void SetAsyncQueueCapacity(size_t capacity);
+    // 获取异步队列容量
+    size_t GetAsyncQueueCapacity() const noexcept;
+
+    // 设置异步队列溢出策略
+    void SetOverflowPolicy(OverflowPolicy policy);
+    // 获取异步队列溢出策略
+    OverflowPolicy GetOverflowPolicy() const noexcept;
+
+    // 设置时间戳精度
+    void SetTimestampPrecision(TimestampPrecision precision);
+    // 获取时间戳精度
+    TimestampPrecision GetTimestampPrecision() const noexcept;
+
+    // 设置捕获日志时间所使用的时钟
+    void SetClockSource(ClockSource source);
+    // 获取捕获日志时间所使用的时钟
+    ClockSource GetClockSource() const noexcept;
+
+    // 设置文件输出的用户态缓冲区大小
+    void SetFileBufferSize(size_t size);
+    // 获取文件输出的用户态缓冲区大小
+    size_t GetFileBufferSize() const noexcept;
+
+    // 设置缓冲区的定时刷新间隔（毫秒，0表示不按时间刷新）
+    void SetFlushIntervalMs(int64_t interval_ms);
+    // 获取缓冲区的定时刷新间隔
+    int64_t GetFlushIntervalMs() const noexcept;
+
+    // 设置立即刷新的日志级别，达到该级别的日志写入后立即刷新
+    void SetFlushLevel(LogLevel level);
+    // 获取立即刷新的日志级别
+    LogLevel GetFlushLevel() const noexcept;
+
+    // 设置日志文件的滚动方式
+    void SetRotationMode(RotationMode mode);
+    // 获取日志文件的滚动方式
+    RotationMode GetRotationMode() const noexcept;
+
+    // 设置是否压缩滚动后的日志文件
+    void SetCompress(bool compress);
+    // 获取是否压缩滚动后的日志文件
+    bool IsCompress() const noexcept;
+
+    // 设置日志文件（含备份）的总大小上限，0表示不限制
+    void SetMaxTotalSize(size_t size);
+    // 获取日志文件的总大小上限
+    size_t GetMaxTotalSize() const noexcept;
+
+    // 设置日志文件的写入方式
+    void SetFileEngine(FileEngine engine);
+    // 获取日志文件的写入方式
+    FileEngine GetFileEngine() const noexcept;
+
+    // 设置日志的输出格式
+    void SetLogLayout(LogLayout layout);
+    // 获取日志的输出格式
+    LogLayout GetLogLayout() const noexcept;
+
+    // 设置每个调用点每秒最多记录的日志数量及允许的突发数量，0表示不限流；burst为0时等于每秒数量。
+    // 超出的日志被丢弃，该调用点下一条被记录的日志之前输出一条说明丢弃数量的日志
+    void SetRateLimit(uint32_t per_second, uint32_t burst = 0);
+    // 获取每个调用点每秒最多记录的日志数量
+    uint32_t GetRateLimit() const noexcept;
+    // 获取每个调用点允许的突发数量，0表示等于每秒数量
+    uint32_t GetRateLimitBurst() const noexcept;
+
+    // 设置是否抑制同一调用点连续重复的日志，重复次数在内容变化时或至多每秒输出一次
+    void SetDeduplicate(bool deduplicate);
+    // 获取是否抑制连续重复的日志
+    bool IsDeduplicate() const noexcept;
+
     // 重置为默认配置
     void ResetToDefault();
 
@@ -59,6 +134,10 @@ private:
     bool IsValidFileCount(int32_t count) const noexcept;
     // 检查文件大小是否有效
     bool IsValidFileSize(size_t size) const noexcept;
+    // 检查异步队列容量是否有效
+    bool IsValidQueueCapacity(size_t capacity) const noexcept;
+    // 检查文件缓冲区大小是否有效
+    bool IsValidFileBufferSize(size_t size) const noexcept;
 
     LogLevel level_;
     LogSink sink_;
@@ -66,6 +145,21 @@ private:
     int32_t max_file_count_;
     size_t max_file_size_;
     bool async_mode_;
+    size_t async_queue_capacity_;
+    OverflowPolicy overflow_policy_;
+    TimestampPrecision timestamp_precision_;
+    ClockSource clock_source_;
+    size_t file_buffer_size_;
+    int64_t flush_interval_ms_;
+    LogLevel flush_level_;
+    RotationMode rotation_mode_;
+    bool compress_;
+    size_t max_total_size_;
+    FileEngine file_engine_;
+    LogLayout layout_;
+    uint32_t rate_limit_;
+    uint32_t rate_limit_burst_;
+    bool deduplicate_;
 
     // 默认配置值
     static constexpr LogLevel kDefaultLogLevel = LogLevel::kInfo;
@@ -73,6 +167,21 @@ private:
     static constexpr int32_t kDefaultMaxFileCount = 5;
     static constexpr size_t kDefaultMaxFileSize = 1024 * 1024;  // 1MB
     static constexpr bool kDefaultAsyncMode = false;
+    static constexpr size_t kDefaultAsyncQueueCapacity = 8192;
+    static constexpr OverflowPolicy kDefaultOverflowPolicy = OverflowPolicy::kBlock;
+    static constexpr TimestampPrecision kDefaultTimestampPrecision = TimestampPrecision::kMilliseconds;
+    static constexpr ClockSource kDefaultClockSource = ClockSource::kRealtime;
+    static constexpr size_t kDefaultFileBufferSize = 64 * 1024;  // 64KB
+    static constexpr int64_t kDefaultFlushIntervalMs = 1000;
+    static constexpr LogLevel kDefaultFlushLevel = LogLevel::kError;
+    static constexpr RotationMode kDefaultRotationMode = RotationMode::kSize;
+    static constexpr bool kDefaultCompress = false;
+    static constexpr size_t kDefaultMaxTotalSize = 0;
+    static constexpr FileEngine kDefaultFileEngine = FileEngine::kBuffered;
+    static constexpr LogLayout kDefaultLogLayout = LogLayout::kText;
+    static constexpr uint32_t kDefaultRateLimit = 0;
+    static constexpr uint32_t kDefaultRateLimitBurst = 0;
+    static constexpr bool kDefaultDeduplicate = false;
 };
 
 }  // namespace tinylog
@@ -0,0 +1,422 @@
+#ifndef TINYLOG_LOG_FORMAT_H_
+#define TINYLOG_LOG_FORMAT_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "log_level.h"
+
+namespace tinylog {
+
+// 格式化字符串，隐式构造时自动记录调用处的文件名、函数名和行号。
+// 字符串字面量在程序运行期间一直有效，只保存其指针，格式化延迟到sink写入时（异步模式下即后台线程）完成；
+// std::string和std::string_view在日志调用返回后可能失效，在调用线程上立即格式化。
+// 字符指针和可修改的字符数组无法判断其生存期，不能隐式转换，需先转换为std::string_view
+struct FormatString {
+    template <size_t N>
+    FormatString(const char (&fmt)[N], const char* file = __builtin_FILE(), const char* func = __builtin_FUNCTION(),
+                 int line_no = __builtin_LINE())
+        : format(fmt), length(std::char_traits<char>::length(fmt)), filename(file), function(func), line(line_no),
+          literal(true) {}
+    FormatString(std::string_view fmt, const char* file = __builtin_FILE(), const char* func = __builtin_FUNCTION(),
+                 int line_no = __builtin_LINE())
+        : format(fmt.data()), length(fmt.size()), filename(file), function(func), line(line_no), literal(false) {}
+    FormatString(const std::string& fmt, const char* file = __builtin_FILE(), const char* func = __builtin_FUNCTION(),
+                 int line_no = __builtin_LINE())
+        : FormatString(std::string_view(fmt), file, func, line_no) {}
+    template <size_t N>
+    FormatString(char (&fmt)[N], const char* file = __builtin_FILE(), const char* func = __builtin_FUNCTION(),
+                 int line_no = __builtin_LINE()) = delete;
+
+    std::string_view view() const noexcept { return std::string_view(format, length); }
+
+    const char* format;
+    size_t length;
+    const char* filename;
+    const char* function;
+    int line;
+    bool literal;  // 是否为字符串字面量，为false时不能在日志调用返回后访问format
+};
+
+// 结构化字段：键和类型化的值，随日志以二进制形式保存，不转换为字符串。
+// 键值对可以与格式参数混合出现，例如 logger.Info("req {} done", id, kv("status", 200), kv("latency_us", t))
+template <typename T>
+struct KeyValue {
+    std::string_view key;
+    const T& value;
+};
+
+template <typename T>
+KeyValue<T> kv(std::string_view key, const T& value) {
+    return KeyValue<T>{key, value};
+}
+
+namespace internal {
+
+// 参数类型标记，写在每个参数的二进制数据之前。
+// kField之后依次是键（与kString相同的长度加内容）和按普通参数编码的值，字段总是位于所有格式参数之后
+enum class ArgType : uint8_t { kBool, kChar, kInt64, kUInt64, kDouble, kPointer, kString, kField };
+
+template <typename T>
+struct IsKeyValue : std::false_type {};
+template <typename T>
+struct IsKeyValue<KeyValue<T>> : std::true_type {};
+template <typename T>
+inline constexpr bool kIsKeyValue = IsKeyValue<std::decay_t<T>>::value;
+
+// 带内部小缓冲区的可增长字节缓冲区：数据较少时直接存放在对象内部，超出后转移到堆上。
+// clear()只重置长度而保留已分配的容量，因此反复复用同一个缓冲区时不会再次分配内存
+template <size_t InlineCapacity>
+class SmallBuffer {
+public:
+    static constexpr size_t kInlineCapacity = InlineCapacity;
+
+    SmallBuffer() = default;
+    ~SmallBuffer() = default;
+
+    SmallBuffer(const SmallBuffer& other) { Append(other.data(), other.size()); }
+    SmallBuffer& operator=(const SmallBuffer& other) {
+        if (this != &other) {
+            clear();
+            Append(other.data(), other.size());
+        }
+        return *this;
+    }
+
+    SmallBuffer(SmallBuffer&& other) noexcept { MoveFrom(other); }
+    SmallBuffer& operator=(SmallBuffer&& other) noexcept {
+        if (this != &other) {
+            heap_.reset();
+            capacity_ = kInlineCapacity;
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    const char* data() const noexcept { return heap_ ? heap_.get() : inline_; }
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+    void clear() noexcept { size_ = 0; }
+    std::string_view view() const noexcept { return std::string_view(data(), size_); }
+
+    void Append(const void* bytes, size_t length) {
+        if (size_ + length > capacity_) {
+            Grow(size_ + length);
+        }
+        if (length > 0) {
+            memcpy((heap_ ? heap_.get() : inline_) + size_, bytes, length);
+        }
+        size_ += length;
+    }
+    void Append(std::string_view str) { Append(str.data(), str.size()); }
+    void Append(char c) {
+        if (size_ + 1 > capacity_) {
+            Grow(size_ + 1);
+        }
+        (heap_ ? heap_.get() : inline_)[size_++] = c;
+    }
+
+private:
+    void Grow(size_t required) {
+        size_t capacity = capacity_ * 2;
+        while (capacity < required) {
+            capacity *= 2;
+        }
+        auto heap = std::make_unique<char[]>(capacity);
+        memcpy(heap.get(), data(), size_);
+        heap_ = std::move(heap);
+        capacity_ = capacity;
+    }
+
+    void MoveFrom(SmallBuffer& other) noexcept {
+        size_ = other.size_;
+        if (other.heap_) {
+            heap_ = std::move(other.heap_);
+            capacity_ = other.capacity_;
+        } else {
+            memcpy(inline_, other.inline_, size_);
+        }
+        other.size_ = 0;
+        other.capacity_ = kInlineCapacity;
+    }
+
+    char inline_[kInlineCapacity];
+    std::unique_ptr<char[]> heap_;
+    size_t size_ = 0;
+    size_t capacity_ = kInlineCapacity;
+};
+
+// 日志参数的二进制缓冲区
+using ArgBuffer = SmallBuffer<64>;
+
+// 日志格式化结果的缓冲区，绝大多数日志无需堆内存
+using FormatBuffer = SmallBuffer<512>;
+
+// 写入调用方提供的固定存储的缓冲区，写满后丢弃多余内容，从不分配内存，供崩溃处理中格式化日志使用
+class FixedBuffer {
+public:
+    FixedBuffer(char* storage, size_t capacity) noexcept : data_(storage), capacity_(capacity) {}
+
+    const char* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    void clear() noexcept { size_ = 0; }
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+
+    void Append(const void* bytes, size_t length) noexcept {
+        length = std::min(length, capacity_ - size_);
+        if (length > 0) {
+            memcpy(data_ + size_, bytes, length);
+        }
+        size_ += length;
+    }
+    void Append(std::string_view str) noexcept { Append(str.data(), str.size()); }
+    void Append(char c) noexcept {
+        if (size_ < capacity_) {
+            data_[size_++] = c;
+        }
+    }
+
+private:
+    char* data_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+template <typename T>
+inline void AppendValue(ArgBuffer& buffer, ArgType type, T value) {
+    buffer.Append(&type, sizeof(type));
+    buffer.Append(&value, sizeof(value));
+}
+
+inline void AppendString(ArgBuffer& buffer, std::string_view str) {
+    ArgType type = ArgType::kString;
+    uint32_t length = static_cast<uint32_t>(str.size());
+    buffer.Append(&type, sizeof(type));
+    buffer.Append(&length, sizeof(length));
+    buffer.Append(str.data(), length);
+}
+
+// 将单个参数编码进缓冲区：算术类型和指针按原始字节复制，字符串复制其内容
+template <typename T>
+inline void EncodeArg(ArgBuffer& buffer, const T& value) {
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_same_v<Type, bool>) {
+        AppendValue(buffer, ArgType::kBool, static_cast<uint8_t>(value));
+    } else if constexpr (std::is_same_v<Type, char>) {
+        AppendValue(buffer, ArgType::kChar, value);
+    } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+        AppendValue(buffer, ArgType::kInt64, static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<Type>) {
+        AppendValue(buffer, ArgType::kUInt64, static_cast<uint64_t>(value));
+    } else if constexpr (std::is_enum_v<Type>) {
+        EncodeArg(buffer, static_cast<std::underlying_type_t<Type>>(value));
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        AppendValue(buffer, ArgType::kDouble, static_cast<double>(value));
+    } else if constexpr (std::is_array_v<T>) {
+        AppendString(buffer, std::string_view(value));
+    } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+        AppendString(buffer, value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+    } else if constexpr (std::is_convertible_v<const Type&, std::string_view>) {
+        AppendString(buffer, std::string_view(value));
+    } else if constexpr (std::is_pointer_v<Type>) {
+        AppendValue(buffer, ArgType::kPointer, reinterpret_cast<uintptr_t>(value));
+    } else {
+        static_assert(std::is_arithmetic_v<Type>, "unsupported log argument type");
+    }
+}
+
+// 编码结构化字段
+template <typename T>
+inline void EncodeField(ArgBuffer& buffer, const KeyValue<T>& field) {
+    ArgType type = ArgType::kField;
+    uint32_t length = static_cast<uint32_t>(field.key.size());
+    buffer.Append(&type, sizeof(type));
+    buffer.Append(&length, sizeof(length));
+    buffer.Append(field.key.data(), length);
+    EncodeArg(buffer, field.value);
+}
+
+// 依次编码所有参数：先编码格式参数，再编码结构化字段
+template <typename... Args>
+inline void EncodeArgs(ArgBuffer& buffer, const Args&... args) {
+    auto encode_arg = [&buffer](const auto& arg) {
+        if constexpr (!kIsKeyValue<decltype(arg)>) {
+            EncodeArg(buffer, arg);
+        }
+    };
+    auto encode_field = [&buffer](const auto& arg) {
+        if constexpr (kIsKeyValue<decltype(arg)>) {
+            EncodeField(buffer, arg);
+        }
+    };
+    (encode_arg(args), ...);
+    (encode_field(args), ...);
+}
+
+// 获取参数类型对应的类型标记，与EncodeArg的编码规则保持一致
+template <typename T>
+constexpr ArgType ArgTypeOf() {
+    using Type = std::decay_t<T>;
+    if constexpr (kIsKeyValue<Type>) {
+        return ArgType::kField;
+    } else if constexpr (std::is_same_v<Type, bool>) {
+        return ArgType::kBool;
+    } else if constexpr (std::is_same_v<Type, char>) {
+        return ArgType::kChar;
+    } else if constexpr (std::is_enum_v<Type>) {
+        return ArgTypeOf<std::underlying_type_t<Type>>();
+    } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+        return ArgType::kInt64;
+    } else if constexpr (std::is_integral_v<Type>) {
+        return ArgType::kUInt64;
+    } else if constexpr (std::is_floating_point_v<Type>) {
+        return ArgType::kDouble;
+    } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*> ||
+                         std::is_convertible_v<const Type&, std::string_view>) {
+        return ArgType::kString;
+    } else if constexpr (std::is_pointer_v<Type>) {
+        return ArgType::kPointer;
+    } else {
+        static_assert(std::is_arithmetic_v<Type>, "unsupported log argument type");
+        return ArgType::kPointer;
+    }
+}
+
+// 编译期格式参数类型列表，结构化字段不对应占位符，不计入其中
+template <typename... Args>
+struct ArgTypeList {
+    static constexpr size_t kCount = (size_t{0} + ... + (kIsKeyValue<Args> ? 0 : 1));
+
+    static constexpr std::array<ArgType, kCount + 1> MakeTypes() {
+        // 末尾多放一个元素，避免无参数时出现空数组
+        constexpr ArgType all[] = {ArgTypeOf<Args>()..., ArgType::kField};
+        std::array<ArgType, kCount + 1> types{};
+        size_t index = 0;
+        for (ArgType type : all) {
+            if (type != ArgType::kField) {
+                types[index++] = type;
+            }
+        }
+        types[kCount] = ArgType::kPointer;
+        return types;
+    }
+
+    static constexpr std::array<ArgType, kCount + 1> kTypes = MakeTypes();
+};
+
+// 从宏参数中推导参数类型列表，第一个参数必须是格式字符串字面量（仅用于decltype，不会被调用）
+template <size_t N, typename... Args>
+ArgTypeList<std::decay_t<Args>...> DeduceArgTypes(const char (&)[N], const Args&...);
+
+// 单个格式字符串最多支持的占位符数量
+inline constexpr size_t kMaxFormatArgs = 16;
+
+// 编译期预解析的格式字符串
+struct FormatSpec {
+    uint16_t placeholder_count = 0;                // 占位符数量
+    uint16_t placeholder_pos[kMaxFormatArgs] = {};  // 各占位符"{}"的起始位置
+    uint16_t length = 0;                           // 格式字符串长度
+    bool has_escapes = false;                      // 是否包含"{{"或"}}"转义
+    bool valid = true;                             // 是否合法（无孤立的花括号且不超过长度限制）
+};
+
+// 解析格式字符串，可在编译期求值
+constexpr FormatSpec ParseFormat(const char* format) {
+    FormatSpec spec;
+    if (format == nullptr) {
+        return spec;
+    }
+
+    size_t i = 0;
+    for (; format[i] != '\0'; ++i) {
+        char c = format[i];
+        if (c == '{' && format[i + 1] == '{') {
+            spec.has_escapes = true;
+            ++i;
+        } else if (c == '{' && format[i + 1] == '}') {
+            if (spec.placeholder_count < kMaxFormatArgs) {
+                spec.placeholder_pos[spec.placeholder_count] = static_cast<uint16_t>(i);
+            }
+            ++spec.placeholder_count;
+            ++i;
+        } else if (c == '}' && format[i + 1] == '}') {
+            spec.has_escapes = true;
+            ++i;
+        } else if (c == '{' || c == '}') {
+            spec.valid = false;
+        }
+    }
+
+    if (i > UINT16_MAX || spec.placeholder_count > kMaxFormatArgs) {
+        spec.valid = false;
+    }
+    spec.length = static_cast<uint16_t>(i);
+    return spec;
+}
+
+// 调用点的限流和去重状态，日志宏在每个调用点静态分配一个，全部为原子变量，检查时不加锁
+struct SiteLimiter {
+    std::atomic<int64_t> next_allowed_ns{0};  // 令牌桶（GCRA）的理论到达时间
+    std::atomic<uint64_t> rate_limited{0};    // 因限流被丢弃、尚未报告的日志数量
+    std::atomic<uint64_t> last_hash{0};       // 上一条日志内容的哈希
+    std::atomic<uint64_t> repeated{0};        // 与上一条内容相同、尚未报告的日志数量
+    std::atomic<int64_t> repeat_report_ns{0};  // 重复次数最迟的报告时间
+};
+
+// 调用点描述符：由日志宏在每个调用点生成一个静态常量，运行时只传递其指针
+struct CallSite {
+    LogLevel level;
+    const char* filename;
+    const char* function;
+    int line;
+    const char* format;        // 格式字符串，为空表示日志内容由调用方直接给出
+    FormatSpec spec;           // 预解析的格式字符串
+    const ArgType* arg_types;  // 参数类型列表
+    size_t arg_count;          // 参数数量
+    SiteLimiter* limiter = nullptr;  // 调用点的限流和去重状态，为空时不限流
+};
+
+// 生成直接给出日志内容的调用点描述符
+constexpr CallSite MakeCallSite(LogLevel level, const char* filename, const char* function, int line,
+                                SiteLimiter* limiter = nullptr) {
+    return CallSite{level, filename, function, line, nullptr, FormatSpec{}, nullptr, 0, limiter};
+}
+
+// 生成格式化日志的调用点描述符
+template <typename TypeList>
+constexpr CallSite MakeCallSite(LogLevel level, const char* filename, const char* function, int line,
+                                const char* format, SiteLimiter* limiter = nullptr) {
+    return CallSite{level, filename, function, line, format, ParseFormat(format), TypeList::kTypes.data(),
+                    TypeList::kCount, limiter};
+}
+
+// 按格式字符串将二进制参数格式化后追加到out，"{}"为占位符，"{{"和"}}"为转义的花括号
+void FormatArgs(std::string_view format, const ArgBuffer& args, FormatBuffer& out);
+// 同上，写入固定缓冲区，不分配内存，只使用异步信号安全的操作
+void FormatArgs(std::string_view format, const ArgBuffer& args, FixedBuffer& out) noexcept;
+
+// 按调用点预解析的格式字符串格式化参数，省去运行时的格式字符串扫描
+void FormatArgs(const CallSite& site, const ArgBuffer& args, FormatBuffer& out);
+
+// 以" key=value"的形式追加参数中的所有结构化字段
+void AppendTextFields(const ArgBuffer& args, FormatBuffer& out);
+void AppendTextFields(const ArgBuffer& args, FixedBuffer& out) noexcept;
+
+// 以",\"key\":value"的形式追加参数中的所有结构化字段，字符串值转义后加引号，数值和布尔值原样输出
+void AppendJsonFields(const ArgBuffer& args, FormatBuffer& out);
+
+}  // namespace internal
+
+}  // namespace tinylog
+
+#endif  // TINYLOG_LOG_FORMAT_H_
@@ -9,6 +9,32 @@ enum class LogLevel { kDebug, kInfo, kWarn, kError, kFatal };
 // 日志输出目标枚举
 enum class LogSink { kConsole, kFile, kBoth };
 
+// 异步模式下队列已满时的处理策略
+enum class OverflowPolicy { kBlock, kDropNewest, kDropOldest };
+
+// 日志时间戳的精度
+enum class TimestampPrecision { kSeconds, kMilliseconds, kMicroseconds };
+
+// 捕获日志时间所使用的时钟
+// kRealtime: 系统实时时钟；kCoarse: 粗粒度单调时钟（精度约为一个时钟节拍）；kTsc: CPU时间戳计数器
+// 后两者开销更低，启动时与实时时钟校准
+enum class ClockSource { kRealtime, kCoarse, kTsc };
+
+// 日志文件的滚动方式
+// kSize: 按文件大小滚动，备份为file.1..file.N；kDaily/kHourly: 按天/小时滚动，备份文件名带时间段，
+// 同一时间段内超过文件大小时同样滚动
+enum class RotationMode { kSize, kDaily, kHourly };
+
+// 日志文件的写入方式
+// kBuffered: 用户态缓冲后批量write；kMmap: 预分配文件并映射到内存，多线程无锁追加；
+// kIoUring: 缓冲后通过io_uring异步提交（Linux，需在编译时启用，否则退化为pwritev）
+enum class FileEngine { kBuffered, kMmap, kIoUring };
+
+// 日志的输出格式
+// kText: [时间戳] [级别] 文件名:函数名:行号 - 日志内容 key=value；kJson: 每条日志一行JSON对象（JSON Lines）；
+// kBinary: 文件按紧凑的二进制格式写入，由tinylog-decode还原为文本，控制台仍输出文本
+enum class LogLayout { kText, kJson, kBinary };
+
 }  // namespace tinylog
 
 #endif  // TINYLOG_LOG_LEVEL_H_
@@ -1,14 +1,51 @@
 #ifndef TINYLOG_LOG_MANAGER_H_
 #define TINYLOG_LOG_MANAGER_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include "log_config.h"
+#include "log_stats.h"
 
 namespace tinylog {
 
 class Logger;
 
+namespace internal {
+
+// 层级模块的级别节点。模块名按点分隔（例如net.http.client），父节点为去掉最后一段的模块，
+// 顶层模块的父节点为根节点（全局级别）。节点创建后直到日志管理器销毁都不会释放
+struct LevelNode {
+    static constexpr uint64_t kLevelBits = 8;
+    static constexpr uint64_t kLevelMask = (uint64_t{1} << kLevelBits) - 1;
+    static constexpr uint64_t kUnset = kLevelMask;
+
+    const LevelNode* parent = nullptr;
+    // 显式设置的级别及设置时的代数：(generation << kLevelBits) | level，kUnset表示继承父节点
+    std::atomic<uint64_t> state{kUnset};
+};
+
+// 级别代数，任何节点的级别变化后递增，日志实例发现代数变化时才重新计算有效级别
+extern std::atomic<uint64_t> g_level_generation;
+
+// 计算节点的有效级别：节点及其祖先中最近一次设置的级别，后设置的父节点级别覆盖此前设置的子节点级别
+LogLevel ResolveLevel(const LevelNode& node) noexcept;
+
+// 设置节点级别，只修改该节点并递增代数。override为false时沿用节点原有的设置代数，不覆盖子节点此前的设置
+void SetNodeLevel(LevelNode& node, LogLevel level, bool override = true);
+
+// 模块日志注册表中的一项，创建后直到日志管理器销毁都不会释放
+struct ModuleEntry {
+    std::string name;
+    LevelNode* level_node = nullptr;
+    std::unique_ptr<Logger> logger;
+};
+
+}  // namespace internal
+
 // 日志管理器，用于管理全局日志和模块日志
 class LogManager {
 public:
@@ -30,27 +67,81 @@ public:
     // 获取全局日志实例
     Logger& GetGlobalLogger();
     
-    // 获取或创建模块日志实例
-    Logger& GetModuleLogger(const std::string& module_name);
-    Logger& GetModuleLogger(const std::string& module_name, const LogConfig& config);
+    // 获取或创建模块日志实例，模块已存在时无锁且不分配内存
+    Logger& GetModuleLogger(std::string_view module_name);
+    Logger& GetModuleLogger(std::string_view module_name, const LogConfig& config);
+
+    // 获取或创建模块日志注册项，返回的引用在日志管理器的生命周期内有效
+    const internal::ModuleEntry& GetModuleEntry(std::string_view module_name);
     
-    // 设置全局日志级别
+    // 设置全局日志级别，同时覆盖此前对所有模块设置的级别，不需要遍历模块
     void SetGlobalLogLevel(LogLevel level);
     
-    // 设置模块日志级别
-    void SetModuleLogLevel(const std::string& module_name, LogLevel level);
+    // 设置模块及其所有子模块（例如net对net.http.client）的日志级别，模块尚未创建时同样生效
+    void SetModuleLogLevel(std::string_view module_name, LogLevel level);
+
+    // 获取模块的有效日志级别
+    LogLevel GetModuleLogLevel(std::string_view module_name);
     
     // 刷新所有日志实例
     void FlushAll();
+
+    // 获取全局日志、所有模块日志和所有输出目标的统计快照
+    LogStats GetStats();
+
+    // 统计定期输出使用的模块名，可通过GetModuleLogger(kStatsModule, config)将统计写入单独的输出目标
+    static constexpr const char* kStatsModule = "tinylog.stats";
+
+    // 将统计快照按行以INFO级别写入kStatsModule模块日志
+    void DumpStats();
+
+    // 启动后台线程每隔interval输出一次统计，再次调用时按新的间隔重新启动
+    void StartStatsDump(std::chrono::milliseconds interval);
+
+    // 停止定期输出统计
+    void StopStatsDump();
+
+    // 安装崩溃处理：收到SIGSEGV、SIGABRT、SIGBUS信号时，在信号处理函数中把文件缓冲区和异步队列中尚未写出的日志
+    // 直接写入文件，追加调用栈后按原有的处理方式重新触发信号；安装后记录kFatal日志时同样写出全部日志和调用栈，
+    // 然后调用abort终止进程。重复调用无副作用
+    void InstallCrashHandler();
     
 private:
     LogManager();
+
+    // 创建模块日志注册项，日志实例的模块名指向注册项保存的字符串。
+    // config为空时模块级别继承父模块，否则按配置显式设置
+    static std::unique_ptr<internal::ModuleEntry> CreateModuleEntry(std::string_view module_name,
+                                                                    internal::LevelNode* level_node,
+                                                                    const LogConfig* config);
     
     // 全局日志实例
     class Impl;
     std::unique_ptr<Impl> impl_;
 };
 
+namespace internal {
+
+// 日志宏在每个调用点保存的模块日志缓存：模块名与上次相同时直接返回缓存的日志实例
+class ModuleLoggerCache {
+public:
+    constexpr ModuleLoggerCache() = default;
+
+    Logger& Get(std::string_view module_name) {
+        const ModuleEntry* entry = entry_.load(std::memory_order_acquire);
+        if (entry == nullptr || entry->name != module_name) {
+            entry = &LogManager::GetInstance().GetModuleEntry(module_name);
+            entry_.store(entry, std::memory_order_release);
+        }
+        return *entry->logger;
+    }
+
+private:
+    std::atomic<const ModuleEntry*> entry_{nullptr};
+};
+
+}  // namespace internal
+
 }  // namespace tinylog
 
 #endif  // TINYLOG_LOG_MANAGER_H_
@@ -0,0 +1,102 @@
+#ifndef TINYLOG_LOG_STATS_H_
+#define TINYLOG_LOG_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tinylog {
+
+// 刷新耗时直方图的桶数：第0个桶为1微秒以内，第i个桶为[2^(i-1), 2^i)微秒，最后一个桶包含所有更长的耗时
+inline constexpr size_t kFlushLatencyBuckets = 24;
+
+// 单个输出目标的统计，同一目标被多个日志实例共享时统计也是共享的
+struct SinkStats {
+    std::string destination;   // 输出目标："console"或"file:"加文件的绝对路径
+    uint64_t bytes_written = 0;  // 写出的字节数
+    uint64_t write_calls = 0;    // 向内核提交写入的次数（每次对应一次write/pwritev或一次io_uring提交）
+    uint64_t rotations = 0;      // 文件滚动次数
+    uint64_t dropped = 0;        // 因目标暂时不可用（如内存映射失败）而丢弃的日志数量
+    uint64_t flushes = 0;        // 刷新次数，即flush_latency_us中的样本总数
+    std::array<uint64_t, kFlushLatencyBuckets> flush_latency_us{};  // 刷新耗时直方图
+
+    // 刷新耗时的近似分位数（所在桶的上界，单位微秒），没有样本时为0
+    uint64_t FlushLatencyPercentileUs(double fraction) const noexcept;
+};
+
+// 单个日志实例的统计
+struct LoggerStats {
+    std::string module;        // 模块名，全局日志和直接构造的日志实例为空
+    uint64_t accepted = 0;     // 通过级别检查且未被抑制的日志数量，包含随后因队列已满而丢弃的日志
+    uint64_t filtered = 0;     // 因级别不足被过滤的日志数量
+    uint64_t suppressed = 0;   // 被调用点限流或去重抑制的日志数量
+    uint64_t dropped = 0;      // 异步模式下因队列已满而丢弃的日志数量
+    size_t queue_capacity = 0;    // 异步模式下所有线程通道的总容量，同步模式为0
+    size_t queue_high_water = 0;  // 后台线程观察到的单个通道的最大积压数量
+};
+
+// 日志管理器的统计快照
+struct LogStats {
+    std::vector<LoggerStats> loggers;  // 全局日志在前，其后为各模块日志
+    std::vector<SinkStats> sinks;      // 当前打开的所有输出目标
+
+    // 格式化为多行key=value文本，每个日志实例和输出目标一行
+    std::string ToString() const;
+};
+
+namespace internal {
+
+// 为新线程分配计数器分片序号，各线程轮流使用不同的分片
+size_t NextCounterStripe() noexcept;
+
+// 当前线程使用的计数器分片序号
+inline size_t CurrentCounterStripe() noexcept {
+    thread_local const size_t stripe = NextCounterStripe();
+    return stripe;
+}
+
+// 分片计数器组：每个分片独占一个缓存行，不同线程累加到不同的分片，读取时汇总所有分片。
+// 写入路径只有一次无竞争的原子累加，不会在线程之间来回传递缓存行
+template <size_t N>
+class StripedCounters {
+public:
+    static constexpr size_t kStripes = 8;
+
+    void Add(size_t index, uint64_t value = 1) noexcept {
+        stripes_[CurrentCounterStripe() % kStripes].values[index].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t Sum(size_t index) const noexcept {
+        uint64_t sum = 0;
+        for (const auto& stripe : stripes_) {
+            sum += stripe.values[index].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    // 复制另一组计数器的值，调用期间两组计数器都不能有并发的累加
+    void CopyFrom(const StripedCounters& other) noexcept {
+        for (size_t i = 0; i < kStripes; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                stripes_[i].values[j].store(other.stripes_[i].values[j].load(std::memory_order_relaxed),
+                                            std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> values[N]{};
+    };
+
+    Stripe stripes_[kStripes];
+};
+
+}  // namespace internal
+
+}  // namespace tinylog
+
+#endif  // TINYLOG_LOG_STATS_H_
@@ -1,19 +1,29 @@
 #ifndef TINYLOG_LOGGER_H_
 #define TINYLOG_LOGGER_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include "log_config.h"
+#include "log_format.h"
 #include "log_manager.h"
+#include "log_stats.h"
 
 namespace tinylog {
 
 namespace internal {
 class SinkInterface;
-}
+class AsyncWriter;
+class EpochDomain;
+struct LogEvent;
+}  // namespace internal
 
 // 日志类，用于记录日志
 class Logger {
@@ -24,8 +34,9 @@ public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    Logger(Logger&&) noexcept;
-    Logger& operator=(Logger&&) noexcept;
+    // 移动时配置文件监控需要重新注册到新对象，注册失败时抛出异常，因此不是noexcept
+    Logger(Logger&&);
+    Logger& operator=(Logger&&);
 
     ~Logger();
 
@@ -39,6 +50,61 @@ public:
     void LogError(const std::string& message, const char* filename, const char* function, int line);
     void LogFatal(const std::string& message, const char* filename, const char* function, int line);
 
+    // 判断指定级别的日志是否需要记录，只读取原子变量，不加锁
+    bool ShouldLog(LogLevel level) const noexcept { return level >= EffectiveLevel(); }
+
+    // 记录一条因级别不足被过滤的日志，供日志宏在级别检查失败时调用
+    void CountFiltered() noexcept { counters_.Add(kFilteredCounter); }
+
+    // 调用点日志记录函数，供LOG_*宏使用，位置信息取自宏生成的静态调用点描述符
+    void Log(const internal::CallSite& site, const std::string& message);
+
+    // 调用点格式化日志记录函数，供LOGF_*宏使用，格式字符串已在编译期解析并存放在调用点描述符中
+    template <size_t N, typename... Args>
+    void LogFormat(const internal::CallSite& site, const char (&)[N], const Args&... args) {
+        if (!ShouldLog(site.level)) {
+            CountFiltered();
+            return;
+        }
+        internal::ArgBuffer buffer;
+        internal::EncodeArgs(buffer, args...);
+        LogFormatted(site, std::move(buffer));
+    }
+
+    // 延迟格式化的日志记录函数：调用线程只复制格式字符串指针和参数的二进制值，
+    // 字符串格式化在sink写入时（异步模式下即后台线程）完成，例如 logger.Info("user {} took {} ms", id, ms)
+    template <typename... Args>
+    void LogFormat(LogLevel level, const FormatString& fmt, const Args&... args) {
+        if (!ShouldLog(level)) {
+            CountFiltered();
+            return;
+        }
+        internal::ArgBuffer buffer;
+        internal::EncodeArgs(buffer, args...);
+        LogFormatted(level, fmt, std::move(buffer));
+    }
+
+    template <typename... Args>
+    void Debug(FormatString fmt, const Args&... args) {
+        LogFormat(LogLevel::kDebug, fmt, args...);
+    }
+    template <typename... Args>
+    void Info(FormatString fmt, const Args&... args) {
+        LogFormat(LogLevel::kInfo, fmt, args...);
+    }
+    template <typename... Args>
+    void Warn(FormatString fmt, const Args&... args) {
+        LogFormat(LogLevel::kWarn, fmt, args...);
+    }
+    template <typename... Args>
+    void Error(FormatString fmt, const Args&... args) {
+        LogFormat(LogLevel::kError, fmt, args...);
+    }
+    template <typename... Args>
+    void Fatal(FormatString fmt, const Args&... args) {
+        LogFormat(LogLevel::kFatal, fmt, args...);
+    }
+
     // 设置日志级别
     void SetLogLevel(LogLevel level);
     // 获取日志级别
@@ -52,49 +118,297 @@ public:
     // 设置日志配置
     void SetConfig(const LogConfig& config);
 
-    // 刷新日志缓存
+    // 刷新日志缓存，异步模式下会等待队列中的日志全部写入。
+    // 先补报各调用点尚未报告的重复和限流数量，析构时同样会补报
     void Flush();
 
+    // 获取异步模式下本日志实例因队列已满而丢弃的日志数量
+    uint64_t GetDroppedCount() const;
+
+    // 获取本日志实例的统计：接受、过滤、抑制和丢弃的日志数量，以及异步队列的最大积压
+    LoggerStats GetStats() const;
+
+    // 获取模块名，全局日志和直接构造的日志实例为空
+    std::string_view GetModuleName() const noexcept { return module_name_; }
+
 private:
-    // 从文件加载配置
-    void LoadConfigFromFile(const std::string& config_file_path);
-    // 初始化日志输出目标
+    friend class LogManager;
+
+    // 当前生效的日志级别。模块日志的级别继承自父模块，缓存的级别在级别代数变化后才重新计算
+    LogLevel EffectiveLevel() const noexcept {
+        if (level_node_ == nullptr) {
+            return level_.load(std::memory_order_relaxed);
+        }
+        uint64_t generation = internal::g_level_generation.load(std::memory_order_acquire);
+        uint64_t cached = level_cache_.load(std::memory_order_relaxed);
+        if ((cached >> internal::LevelNode::kLevelBits) == generation) {
+            return static_cast<LogLevel>(cached & internal::LevelNode::kLevelMask);
+        }
+        return RefreshLevel(generation);
+    }
+    // 重新计算并缓存模块日志的有效级别
+    LogLevel RefreshLevel(uint64_t generation) const noexcept;
+
+    // 记录已编码参数的日志
+    void LogFormatted(LogLevel level, const FormatString& fmt, internal::ArgBuffer&& args);
+    void LogFormatted(const internal::CallSite& site, internal::ArgBuffer&& args);
+    // 日志记录使用的不可变配置快照：配置、输出目标和异步写入器
+    struct State;
+    // 在读取区内以当前快照调用function，不加锁；快照正在替换参数改变的sink时等待替换完成
+    template <typename Function>
+    void WithState(Function&& function);
+    // 计数并按调用点的限流和去重状态决定是否记录event，返回false表示丢弃；
+    // 此前被抑制的日志数量以单独的日志先于event输出。limiter为空时不限流
+    bool AdmitEvent(const State& state, internal::SiteLimiter* limiter, const internal::LogEvent& event);
+    // 输出一条说明被抑制数量的日志，repeated为true表示重复被抑制，否则为被限流
+    void ReportSuppressed(const State& state, const internal::LogEvent& event, uint64_t count, bool repeated);
+    // 登记event所在调用点有尚未报告的抑制数量，每个调用点只登记一次
+    void AddPendingReport(internal::SiteLimiter* limiter, const internal::LogEvent& event);
+    // 报告所有登记的调用点尚未报告的抑制数量，调用方需持有config_mutex_
+    void ReportPending(const State& state);
+    // 将日志事件交给异步写入器或直接写入sink
+    void DispatchEvent(const State& state, internal::LogEvent&& event);
+    // 发布新的快照并在读取方离开后释放旧快照，调用方需持有config_mutex_
+    void PublishState(std::unique_ptr<State> state);
+
+    // 从文件加载配置，文件中未出现的配置项保持config中的原值
+    static void LoadConfigFromFile(const std::string& config_file_path, LogConfig& config);
+    // 按config_创建新的快照并发布，调用方需持有config_mutex_
     void InitSinks();
     // 重新初始化日志输出目标
     void ReInitSinks();
     // 验证配置有效性
     void ValidateConfig();
 
-    // 配置文件监控相关
+    // 配置文件监控相关，所有日志实例共用一个监控线程
     void StartConfigFileMonitor();
     void StopConfigFileMonitor();
-    void MonitorConfigFile();
+    // 配置文件变化后重新加载，参数未变的输出目标保持打开
+    void ReloadConfigFile();
 
     LogConfig config_;
     std::string config_file_path_;
+    // 当前日志级别，与config_中的级别保持一致，供无锁的级别检查使用
+    std::atomic<LogLevel> level_{LogLevel::kInfo};
+    // 模块日志的级别节点，全局日志和直接构造的日志实例为空
+    internal::LevelNode* level_node_ = nullptr;
+    // 缓存的有效级别：(级别代数 << kLevelBits) | level
+    mutable std::atomic<uint64_t> level_cache_{0};
+
+    // 模块名，指向日志管理器中模块注册项保存的字符串，随日志事件传递给格式化器
+    std::string_view module_name_;
 
-    std::vector<std::shared_ptr<internal::SinkInterface>> sinks_;
+    // 当前快照：日志记录线程在读取区内无锁读取state_，修改配置的线程在新快照发布后
+    // 等待读取方离开再释放旧快照。快照的输出目标和异步写入器从sink注册表获取，相同目标的日志实例共享同一个实例
+    std::atomic<const State*> state_{nullptr};
+    std::unique_ptr<State> state_owner_;
+    std::unique_ptr<internal::EpochDomain> epoch_;
+    // 异步模式下累计丢弃的日志数量
+    std::atomic<uint64_t> dropped_count_{0};
+    // 接受、过滤和被限流或去重抑制的日志数量，按线程分片累加
+    enum LoggerCounter : size_t { kAcceptedCounter, kFilteredCounter, kSuppressedCounter, kLoggerCounterCount };
+    internal::StripedCounters<kLoggerCounterCount> counters_;
 
+    // 保护config_和快照的替换，日志记录线程不获取该锁
     mutable std::mutex config_mutex_;
-    bool is_monitoring_ = false;
-    std::thread config_monitor_thread_;
+    // 配置文件的监控标识，0表示未监控
+    uint64_t config_watch_id_ = 0;
+
+    // 曾有日志被抑制的调用点及其位置信息，之后没有日志经过该调用点时由Flush补报抑制数量
+    struct PendingReport {
+        internal::SiteLimiter* limiter;
+        LogLevel level;
+        const char* filename;
+        const char* function;
+        int line;
+    };
+    std::mutex pending_mutex_;
+    std::vector<PendingReport> pending_reports_;
 };
 
+namespace internal {
+
+// 采样日志宏在每个调用点保存的静态计数器，多个线程共享同一调用点的采样状态。
+// 未被采样的调用只有一次relaxed原子操作（按时间采样另有一次时钟读取），不会调用日志实例
+class SiteSampler {
+public:
+    constexpr SiteSampler() = default;
+
+    // 第1、n+1、2n+1...次调用返回true，n不大于1时每次都返回true
+    bool EveryN(int64_t n) noexcept {
+        uint64_t count = count_.fetch_add(1, std::memory_order_relaxed);
+        return n <= 1 || count % static_cast<uint64_t>(n) == 0;
+    }
+
+    // 前n次调用返回true；达到n次后只读取计数器，不再累加
+    bool FirstN(int64_t n) noexcept {
+        return static_cast<int64_t>(count_.load(std::memory_order_relaxed)) < n &&
+               static_cast<int64_t>(count_.fetch_add(1, std::memory_order_relaxed)) < n;
+    }
+
+    // 首次调用以及距上次返回true至少经过interval后的第一次调用返回true，并发调用时只有一个线程返回true
+    template <typename Rep, typename Period>
+    bool EveryT(std::chrono::duration<Rep, Period> interval) noexcept {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+        int64_t next = next_ns_.load(std::memory_order_relaxed);
+        if (now < next) {
+            return false;
+        }
+        int64_t interval_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+        return next_ns_.compare_exchange_strong(next, now + interval_ns, std::memory_order_relaxed);
+    }
+
+    // 间隔为秒数，可以是小数
+    bool EveryT(double seconds) noexcept { return EveryT(std::chrono::duration<double>(seconds)); }
+
+private:
+    std::atomic<uint64_t> count_{0};
+    std::atomic<int64_t> next_ns_{INT64_MIN};
+};
+
+}  // namespace internal
+
 }  // namespace tinylog
 
+// 取可变参数中的第一个参数
+#define TINYLOG_FIRST_ARG(...) TINYLOG_FIRST_ARG_IMPL(__VA_ARGS__, unused)
+#define TINYLOG_FIRST_ARG_IMPL(first, ...) first
+
+// 编译期最低日志级别，低于该级别的日志宏会被完全移除，例如 -DTINYLOG_MIN_LEVEL=TINYLOG_LEVEL_INFO
+#define TINYLOG_LEVEL_DEBUG 0
+#define TINYLOG_LEVEL_INFO 1
+#define TINYLOG_LEVEL_WARN 2
+#define TINYLOG_LEVEL_ERROR 3
+#define TINYLOG_LEVEL_FATAL 4
+#ifndef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+#endif
+
+// 判断日志级别在编译期是否启用
+#define TINYLOG_LEVEL_ENABLED(log_level) (static_cast<int>(log_level) >= TINYLOG_MIN_LEVEL)
+
+// 在调用点生成静态的调用点描述符（级别、文件名、函数名、行号），运行时只传递描述符和日志内容。
+// 级别检查在日志内容表达式求值之前完成，被过滤的日志不会构造消息字符串
+#define TINYLOG_LOG_SITE(logger, log_level, message)                                                           \
+    do {                                                                                                       \
+        if constexpr (TINYLOG_LEVEL_ENABLED(log_level)) {                                                      \
+            auto& tinylog_logger = (logger);                                                                   \
+            if (tinylog_logger.ShouldLog(log_level)) {                                                         \
+                static ::tinylog::internal::SiteLimiter tinylog_site_limiter;                                  \
+                static constexpr ::tinylog::internal::CallSite tinylog_call_site =                             \
+                    ::tinylog::internal::MakeCallSite(log_level, __FILE__, __func__, __LINE__,                 \
+                                                      &tinylog_site_limiter);                                  \
+                tinylog_logger.Log(tinylog_call_site, message);                                                \
+            } else {                                                                                           \
+                tinylog_logger.CountFiltered();                                                                \
+            }                                                                                                  \
+        }                                                                                                      \
+    } while (0)
+
+// 格式化日志的调用点宏：格式字符串在编译期解析，占位符与参数数量不一致或参数类型不支持时编译失败
+#define TINYLOG_LOGF_SITE(logger, log_level, ...)                                                              \
+    do {                                                                                                       \
+        using TinylogArgTypes = decltype(::tinylog::internal::DeduceArgTypes(__VA_ARGS__));                    \
+        static ::tinylog::internal::SiteLimiter tinylog_site_limiter;                                          \
+        static constexpr ::tinylog::internal::CallSite tinylog_call_site =                                     \
+            ::tinylog::internal::MakeCallSite<TinylogArgTypes>(log_level, __FILE__, __func__, __LINE__,        \
+                                                               TINYLOG_FIRST_ARG(__VA_ARGS__),                 \
+                                                               &tinylog_site_limiter);                         \
+        static_assert(tinylog_call_site.spec.valid, "invalid log format string");                              \
+        static_assert(tinylog_call_site.spec.placeholder_count == tinylog_call_site.arg_count,                 \
+                      "log format placeholders do not match the number of arguments");                        \
+        if constexpr (TINYLOG_LEVEL_ENABLED(log_level)) {                                                      \
+            auto& tinylog_logger = (logger);                                                                   \
+            if (tinylog_logger.ShouldLog(log_level)) {                                                         \
+                tinylog_logger.LogFormat(tinylog_call_site, __VA_ARGS__);                                      \
+            } else {                                                                                           \
+                tinylog_logger.CountFiltered();                                                                \
+            }                                                                                                  \
+        }                                                                                                      \
+    } while (0)
+
+#define TINYLOG_GLOBAL_LOGGER() tinylog::LogManager::GetInstance().GetGlobalLogger()
+// 每个调用点拥有一个静态的模块日志缓存，模块名不变时无需查找注册表
+#define TINYLOG_MODULE_LOGGER(module_name)                                \
+    ([]() -> tinylog::internal::ModuleLoggerCache& {                      \
+        static tinylog::internal::ModuleLoggerCache tinylog_module_cache; \
+        return tinylog_module_cache;                                      \
+    }().Get(module_name))
+
 // 宏定义，方便用户调用日志函数，自动传入文件名、函数名和行号
 // 全局日志宏，无需显式传入logger实例
-#define LOG_DEBUG(message) tinylog::LogManager::GetInstance().GetGlobalLogger().LogDebug(message, __FILE__, __func__, __LINE__)
-#define LOG_INFO(message) tinylog::LogManager::GetInstance().GetGlobalLogger().LogInfo(message, __FILE__, __func__, __LINE__)
-#define LOG_WARN(message) tinylog::LogManager::GetInstance().GetGlobalLogger().LogWarn(message, __FILE__, __func__, __LINE__)
-#define LOG_ERROR(message) tinylog::LogManager::GetInstance().GetGlobalLogger().LogError(message, __FILE__, __func__, __LINE__)
-#define LOG_FATAL(message) tinylog::LogManager::GetInstance().GetGlobalLogger().LogFatal(message, __FILE__, __func__, __LINE__)
+#define LOG_DEBUG(message) TINYLOG_LOG_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kDebug, message)
+#define LOG_INFO(message) TINYLOG_LOG_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kInfo, message)
+#define LOG_WARN(message) TINYLOG_LOG_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kWarn, message)
+#define LOG_ERROR(message) TINYLOG_LOG_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kError, message)
+#define LOG_FATAL(message) TINYLOG_LOG_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kFatal, message)
 
 // 模块日志宏，需要指定模块名
-#define LOG_MODULE_DEBUG(module_name, message) tinylog::LogManager::GetInstance().GetModuleLogger(module_name).LogDebug(message, __FILE__, __func__, __LINE__)
-#define LOG_MODULE_INFO(module_name, message) tinylog::LogManager::GetInstance().GetModuleLogger(module_name).LogInfo(message, __FILE__, __func__, __LINE__)
-#define LOG_MODULE_WARN(module_name, message) tinylog::LogManager::GetInstance().GetModuleLogger(module_name).LogWarn(message, __FILE__, __func__, __LINE__)
-#define LOG_MODULE_ERROR(module_name, message) tinylog::LogManager::GetInstance().GetModuleLogger(module_name).LogError(message, __FILE__, __func__, __LINE__)
-#define LOG_MODULE_FATAL(module_name, message) tinylog::LogManager::GetInstance().GetModuleLogger(module_name).LogFatal(message, __FILE__, __func__, __LINE__)
+#define LOG_MODULE_DEBUG(module_name, message) \
+    TINYLOG_LOG_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kDebug, message)
+#define LOG_MODULE_INFO(module_name, message) \
+    TINYLOG_LOG_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kInfo, message)
+#define LOG_MODULE_WARN(module_name, message) \
+    TINYLOG_LOG_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kWarn, message)
+#define LOG_MODULE_ERROR(module_name, message) \
+    TINYLOG_LOG_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kError, message)
+#define LOG_MODULE_FATAL(module_name, message) \
+    TINYLOG_LOG_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kFatal, message)
+
+// 格式化日志宏，第一个参数为格式字符串字面量，例如 LOGF_INFO("user {} took {} ms", id, ms)
+#define LOGF_DEBUG(...) TINYLOG_LOGF_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kDebug, __VA_ARGS__)
+#define LOGF_INFO(...) TINYLOG_LOGF_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kInfo, __VA_ARGS__)
+#define LOGF_WARN(...) TINYLOG_LOGF_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kWarn, __VA_ARGS__)
+#define LOGF_ERROR(...) TINYLOG_LOGF_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kError, __VA_ARGS__)
+#define LOGF_FATAL(...) TINYLOG_LOGF_SITE(TINYLOG_GLOBAL_LOGGER(), tinylog::LogLevel::kFatal, __VA_ARGS__)
+
+// 模块格式化日志宏
+#define LOGF_MODULE_DEBUG(module_name, ...) \
+    TINYLOG_LOGF_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kDebug, __VA_ARGS__)
+#define LOGF_MODULE_INFO(module_name, ...) \
+    TINYLOG_LOGF_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kInfo, __VA_ARGS__)
+#define LOGF_MODULE_WARN(module_name, ...) \
+    TINYLOG_LOGF_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kWarn, __VA_ARGS__)
+#define LOGF_MODULE_ERROR(module_name, ...) \
+    TINYLOG_LOGF_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kError, __VA_ARGS__)
+#define LOGF_MODULE_FATAL(module_name, ...) \
+    TINYLOG_LOGF_SITE(TINYLOG_MODULE_LOGGER(module_name), tinylog::LogLevel::kFatal, __VA_ARGS__)
+
+// 调用点采样：sample为SiteSampler的采样方法调用，被采样时才执行日志语句
+#define TINYLOG_SAMPLED(sample, log_statement)                        \
+    do {                                                              \
+        static ::tinylog::internal::SiteSampler tinylog_site_sampler; \
+        if (tinylog_site_sampler.sample) {                            \
+            log_statement;                                            \
+        }                                                             \
+    } while (0)
+
+// 采样日志宏，level为DEBUG、INFO、WARN、ERROR或FATAL，例如 LOG_EVERY_N(DEBUG, 1000, "processed " + id)
+// EVERY_N记录第1、n+1、2n+1...次调用，FIRST_N只记录前n次调用，EVERY_T每隔至少interval记录一次。
+// interval为秒数（可以是小数）或std::chrono的时间间隔。采样先于级别检查，被过滤的级别同样计数
+#define LOG_EVERY_N(level, n, message) TINYLOG_SAMPLED(EveryN(n), LOG_##level(message))
+#define LOG_FIRST_N(level, n, message) TINYLOG_SAMPLED(FirstN(n), LOG_##level(message))
+#define LOG_EVERY_T(level, interval, message) TINYLOG_SAMPLED(EveryT(interval), LOG_##level(message))
+
+#define LOG_MODULE_EVERY_N(module_name, level, n, message) \
+    TINYLOG_SAMPLED(EveryN(n), LOG_MODULE_##level(module_name, message))
+#define LOG_MODULE_FIRST_N(module_name, level, n, message) \
+    TINYLOG_SAMPLED(FirstN(n), LOG_MODULE_##level(module_name, message))
+#define LOG_MODULE_EVERY_T(module_name, level, interval, message) \
+    TINYLOG_SAMPLED(EveryT(interval), LOG_MODULE_##level(module_name, message))
+
+// 格式化采样日志宏，例如 LOGF_EVERY_N(INFO, 100, "item {} done", id)
+#define LOGF_EVERY_N(level, n, ...) TINYLOG_SAMPLED(EveryN(n), LOGF_##level(__VA_ARGS__))
+#define LOGF_FIRST_N(level, n, ...) TINYLOG_SAMPLED(FirstN(n), LOGF_##level(__VA_ARGS__))
+#define LOGF_EVERY_T(level, interval, ...) TINYLOG_SAMPLED(EveryT(interval), LOGF_##level(__VA_ARGS__))
+
+#define LOGF_MODULE_EVERY_N(module_name, level, n, ...) \
+    TINYLOG_SAMPLED(EveryN(n), LOGF_MODULE_##level(module_name, __VA_ARGS__))
+#define LOGF_MODULE_FIRST_N(module_name, level, n, ...) \
+    TINYLOG_SAMPLED(FirstN(n), LOGF_MODULE_##level(module_name, __VA_ARGS__))
+#define LOGF_MODULE_EVERY_T(module_name, level, interval, ...) \
+    TINYLOG_SAMPLED(EveryT(interval), LOGF_MODULE_##level(module_name, __VA_ARGS__))
 
 #endif  // TINYLOG_LOGGER_H_
@@ -0,0 +1,385 @@
+#include "tinylog/internal/async_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <utility>
+
+#include "tinylog/internal/crash_handler.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+// 后台线程空闲时的最长休眠时间
+// 剩余容量不足时新通道保留的最小容量
+constexpr size_t kMinLaneCapacity = 256;
+
+// 不超过value的最大的2的幂（至少为2），通道按此分配，队列不会再向上取整而超出总容量
+size_t FloorPowerOfTwo(size_t value) {
+    size_t size = 2;
+    while (size <= value / 2) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// 单个通道的容量上限：总容量按CPU核数均分
+size_t LaneCapacity(size_t total_capacity) {
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return FloorPowerOfTwo(std::min(total_capacity, std::max(total_capacity / threads, kMinLaneCapacity)));
+}
+constexpr auto kIdleWaitTime = std::chrono::milliseconds(10);
+
+std::atomic<uint64_t> g_next_writer_id{1};
+
+// 线程私有的通道缓存，线程退出时将其拥有的通道标记为关闭
+class ThreadLaneCache {
+public:
+    struct Entry {
+        uint64_t writer_id;
+        std::shared_ptr<ThreadLane> lane;
+    };
+
+    ~ThreadLaneCache() {
+        for (auto& entry : entries_) {
+            entry.lane->closed.store(true, std::memory_order_release);
+        }
+    }
+
+    ThreadLane* Find(uint64_t writer_id) {
+        if (last_ != nullptr && last_->writer_id == writer_id) {
+            return last_->lane.get();
+        }
+        for (auto& entry : entries_) {
+            if (entry.writer_id == writer_id) {
+                last_ = &entry;
+                return entry.lane.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void Add(uint64_t writer_id, std::shared_ptr<ThreadLane> lane) {
+        // 顺便清理已销毁写入器的通道
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                      [](const Entry& entry) {
+                                          return entry.lane->orphaned.load(std::memory_order_acquire);
+                                      }),
+                       entries_.end());
+        entries_.push_back(Entry{writer_id, std::move(lane)});
+        last_ = &entries_.back();
+    }
+
+private:
+    std::vector<Entry> entries_;
+    Entry* last_ = nullptr;
+};
+
+ThreadLaneCache& GetThreadLaneCache() {
+    thread_local ThreadLaneCache cache;
+    return cache;
+}
+
+}  // namespace
+
+AsyncWriter::AsyncWriter(std::vector<std::shared_ptr<SinkInterface>> sinks, size_t queue_capacity,
+                         OverflowPolicy policy)
+    : id_(g_next_writer_id.fetch_add(1, std::memory_order_relaxed)),
+      total_capacity_(queue_capacity),
+      lane_capacity_(LaneCapacity(queue_capacity)),
+      min_lane_capacity_(FloorPowerOfTwo(std::min(queue_capacity, kMinLaneCapacity))),
+      policy_(policy),
+      sinks_(std::move(sinks)) {
+    worker_ = std::thread(&AsyncWriter::Run, this);
+    RegisterCrashWriter(this);
+}
+
+AsyncWriter::~AsyncWriter() {
+    UnregisterCrashWriter(this);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.store(false, std::memory_order_seq_cst);
+    }
+    wake_cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(lanes_mutex_);
+    for (const auto& lane : lanes_) {
+        lane->orphaned.store(true, std::memory_order_release);
+    }
+    for (const auto& sink : sinks_) {
+        sink->flush();
+    }
+}
+
+size_t AsyncWriter::Enqueue(LogEvent&& event) {
+    ThreadLane& lane = GetThreadLane();
+    size_t dropped = 0;
+    while (!lane.queue.TryPushSingleProducer(std::move(event))) {
+        UpdateHighWater(lane.queue.Capacity());
+        switch (policy_) {
+            case OverflowPolicy::kDropNewest:
+                dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                return 1;
+            case OverflowPolicy::kDropOldest: {
+                // 从自己的通道弹出最旧的日志为新日志腾出空间
+                LogEvent oldest;
+                if (lane.queue.TryPop(oldest)) {
+                    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                    ++dropped;
+                }
+                break;
+            }
+            case OverflowPolicy::kBlock:
+            default:
+                WakeUp();
+                std::this_thread::yield();
+                break;
+        }
+    }
+
+    WakeUp();
+    return dropped;
+}
+
+void AsyncWriter::Flush() {
+    // 记录调用时各通道的入队位置，等待后台线程写到这些位置
+    std::vector<std::pair<std::shared_ptr<ThreadLane>, size_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(lanes_mutex_);
+        targets.reserve(lanes_.size());
+        for (const auto& lane : lanes_) {
+            targets.emplace_back(lane, lane->queue.EnqueuePosition());
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_cv_.notify_one();
+        flushed_cv_.wait(lock, [this, &targets] {
+            if (!running_.load(std::memory_order_acquire)) {
+                return true;
+            }
+            for (const auto& target : targets) {
+                if (target.first->completed_pos.load(std::memory_order_acquire) < target.second) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    for (const auto& sink : sinks_) {
+        sink->flush();
+    }
+}
+
+void AsyncWriter::CrashDrain() noexcept {
+    // 通道列表的锁被其他线程持有时列表可能正在修改，无法安全遍历
+    if (!CrashTryLock(lanes_mutex_)) {
+        return;
+    }
+
+    // 每条日志构造在同一块存储上且不析构，避免在信号处理函数中释放内存
+    alignas(LogEvent) static unsigned char storage[sizeof(LogEvent)];
+    for (const auto& lane : lanes_) {
+        // 先写出后台线程已取出、尚未写入的队首日志
+        bool has_head = lane->has_head.load(std::memory_order_acquire);
+        for (;;) {
+            const LogEvent* event = &lane->head;
+            if (!has_head) {
+                LogEvent* popped = new (storage) LogEvent();
+                if (!lane->queue.TryPop(*popped)) {
+                    break;
+                }
+                event = popped;
+            }
+            has_head = false;
+            std::string_view record = CrashFormatEvent(*event);
+            for (const auto& sink : sinks_) {
+                int fd = CrashSinkFd(*sink);
+                if (fd >= 0) {
+                    CrashWrite(fd, record.data(), record.size());
+                }
+            }
+        }
+    }
+    lanes_mutex_.unlock();
+}
+
+uint64_t AsyncWriter::GetDroppedCount() const noexcept { return dropped_count_.load(std::memory_order_relaxed); }
+
+ThreadLane& AsyncWriter::GetThreadLane() {
+    ThreadLaneCache& cache = GetThreadLaneCache();
+    ThreadLane* lane = cache.Find(id_);
+    if (lane != nullptr) {
+        return *lane;
+    }
+
+    std::shared_ptr<ThreadLane> new_lane;
+    {
+        std::lock_guard<std::mutex> lock(lanes_mutex_);
+        new_lane = std::make_shared<ThreadLane>(ReserveLaneCapacity());
+        lanes_.push_back(new_lane);
+        lanes_version_.fetch_add(1, std::memory_order_release);
+    }
+    lane = new_lane.get();
+    cache.Add(id_, std::move(new_lane));
+    return *lane;
+}
+
+size_t AsyncWriter::ReserveLaneCapacity() {
+    size_t remaining = total_capacity_ > reserved_capacity_ ? total_capacity_ - reserved_capacity_ : 0;
+    size_t capacity = remaining >= min_lane_capacity_ ? FloorPowerOfTwo(std::min(lane_capacity_, remaining))
+                                                      : min_lane_capacity_;
+    reserved_capacity_ += capacity;
+    return capacity;
+}
+
+void AsyncWriter::Run() {
+    bool has_unflushed = false;
+    for (;;) {
+        if (Drain() > 0) {
+            has_unflushed = true;
+            std::lock_guard<std::mutex> lock(mutex_);
+            flushed_cv_.notify_all();
+            continue;
+        }
+
+        // 队列写空后刷新各sink的缓冲区，空闲期间不会有日志滞留在缓冲区中
+        if (has_unflushed) {
+            for (const auto& sink : sinks_) {
+                sink->flush();
+            }
+            has_unflushed = false;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        flushed_cv_.notify_all();
+        if (!running_.load(std::memory_order_seq_cst)) {
+            break;
+        }
+        // 与WakeUp中的栅栏配对：要么生产者看到休眠标记并通知，要么这里看到它刚入队的日志而不休眠
+        sleeping_.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!HasPendingEvents()) {
+            wake_cv_.wait_for(lock, kIdleWaitTime);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // 退出前写完各通道中剩余的日志
+    while (Drain() > 0) {
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushed_cv_.notify_all();
+}
+
+size_t AsyncWriter::Drain() {
+    PrepareCrashThread();
+
+    // 通道列表有变化时重新复制，并回收已关闭且写空的通道
+    if (lanes_version_.load(std::memory_order_acquire) != active_lanes_version_) {
+        std::lock_guard<std::mutex> lock(lanes_mutex_);
+        active_lanes_ = lanes_;
+        active_lanes_version_ = lanes_version_.load(std::memory_order_relaxed);
+    }
+
+    // 每轮最多处理本轮开始时已在各通道中的日志，持续写入时也能定期更新完成位置
+    merge_heap_.clear();
+    size_t budget = 0;
+    bool has_closed_lane = false;
+    for (size_t i = 0; i < active_lanes_.size(); ++i) {
+        ThreadLane& lane = *active_lanes_[i];
+        // 先读取关闭标记再出队，保证回收时通道中已没有遗漏的日志
+        bool closed = lane.closed.load(std::memory_order_acquire);
+        UpdateHighWater(lane.queue.ApproxSize());
+        if (lane.has_head.load(std::memory_order_relaxed) || LoadHead(lane)) {
+            merge_heap_.emplace_back(lane.head.timestamp, i);
+            budget += 1 + lane.queue.ApproxSize();
+        } else {
+            has_closed_lane = has_closed_lane || closed;
+        }
+    }
+
+    // 多路归并：每次写出队首时间戳最小的日志，它不晚于所有非空通道的队首（低水位），再补充该通道的队首。
+    // 同一通道内的日志本身有序；空通道之后入队的日志在检查之后才产生，不会早于已写出的日志
+    auto later = std::greater<std::pair<int64_t, size_t>>();
+    std::make_heap(merge_heap_.begin(), merge_heap_.end(), later);
+    size_t count = 0;
+    while (count < budget && !merge_heap_.empty()) {
+        std::pop_heap(merge_heap_.begin(), merge_heap_.end(), later);
+        size_t index = merge_heap_.back().second;
+        merge_heap_.pop_back();
+
+        ThreadLane& lane = *active_lanes_[index];
+        lane.has_head.store(false, std::memory_order_relaxed);
+        SinkInterface::dispatch(lane.head, sinks_);
+        ++count;
+        if (LoadHead(lane)) {
+            merge_heap_.emplace_back(lane.head.timestamp, index);
+            std::push_heap(merge_heap_.begin(), merge_heap_.end(), later);
+        }
+    }
+
+    // 持有队首的通道写完到取出队首前的位置，其余通道写完到当前出队位置（之后出队的只有生产者丢弃的日志）
+    for (const auto& lane : active_lanes_) {
+        size_t completed = lane->has_head.load(std::memory_order_relaxed) ? lane->head_pos
+                                                                          : lane->queue.DequeuePosition();
+        lane->completed_pos.store(completed, std::memory_order_release);
+    }
+
+    if (has_closed_lane) {
+        std::lock_guard<std::mutex> lock(lanes_mutex_);
+        lanes_.erase(std::remove_if(lanes_.begin(), lanes_.end(),
+                                    [this](const std::shared_ptr<ThreadLane>& lane) {
+                                        bool drained = lane->closed.load(std::memory_order_acquire) &&
+                                                       !lane->has_head.load(std::memory_order_relaxed) &&
+                                                       lane->queue.ApproxSize() == 0;
+                                        if (drained) {
+                                            reserved_capacity_ -= lane->queue.Capacity();
+                                        }
+                                        return drained;
+                                    }),
+                     lanes_.end());
+        lanes_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    return count;
+}
+
+bool AsyncWriter::LoadHead(ThreadLane& lane) {
+    lane.head_pos = lane.queue.DequeuePosition();
+    if (!lane.queue.TryPop(lane.head)) {
+        return false;
+    }
+    lane.has_head.store(true, std::memory_order_release);
+    return true;
+}
+
+bool AsyncWriter::HasPendingEvents() {
+    std::lock_guard<std::mutex> lock(lanes_mutex_);
+    return std::any_of(lanes_.begin(), lanes_.end(),
+                       [](const std::shared_ptr<ThreadLane>& lane) { return lane->queue.ApproxSize() > 0; });
+}
+
+void AsyncWriter::UpdateHighWater(size_t depth) noexcept {
+    size_t current = queue_high_water_.load(std::memory_order_relaxed);
+    while (depth > current && !queue_high_water_.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {
+    }
+}
+
+void AsyncWriter::WakeUp() {
+    // 只有后台线程休眠时才需要加锁通知；栅栏保证入队先于读取休眠标记，与Run中的栅栏配对避免丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+}  // namespace tinylog::internal
@@ -0,0 +1,276 @@
+#include "tinylog/internal/binary_log.h"
+
+#include <cstring>
+
+#include "tinylog/internal/sink_interface.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+void AppendVarint(uint64_t value, FormatBuffer& out) {
+    char bytes[10];
+    size_t length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = static_cast<char>(value);
+    out.Append(bytes, length);
+}
+
+void AppendBytes(std::string_view bytes, FormatBuffer& out) {
+    AppendVarint(bytes.size(), out);
+    out.Append(bytes);
+}
+
+void AppendType(binary_log::EntryType type, FormatBuffer& out) { out.Append(static_cast<char>(type)); }
+
+uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+constexpr uint64_t kMaxStringLength = 1ULL << 30;
+
+std::string_view NonNull(const char* str) { return str != nullptr ? std::string_view(str) : std::string_view(); }
+
+}  // namespace
+
+void BinaryLogEncoder::BeginSession(bool with_header, FormatBuffer& out) {
+    if (with_header) {
+        out.Append(binary_log::kMagic, sizeof(binary_log::kMagic));
+        out.Append(static_cast<char>(binary_log::kVersion));
+    }
+    AppendType(binary_log::EntryType::kSession, out);
+    sites_.clear();
+    modules_.clear();
+    last_timestamp_ = 0;
+}
+
+void BinaryLogEncoder::Encode(const LogEvent& event, FormatBuffer& out) {
+    uint64_t site_id = SiteId(event, out);
+    uint64_t module_id = event.module.empty() ? 0 : ModuleId(event.module, out) + 1;
+
+    AppendType(binary_log::EntryType::kRecord, out);
+    AppendVarint(site_id, out);
+    AppendVarint(module_id, out);
+    // 异步模式下多个线程的日志可能不按时间顺序到达，时间差可能为负
+    AppendVarint(ZigZagEncode(event.timestamp - last_timestamp_), out);
+    last_timestamp_ = event.timestamp;
+    if (event.Format() != nullptr) {
+        AppendBytes(event.args.view(), out);
+    } else {
+        AppendBytes(event.message, out);
+    }
+}
+
+uint64_t BinaryLogEncoder::SiteId(const LogEvent& event, FormatBuffer& out) {
+    SiteKey key{event.site, nullptr, nullptr, nullptr, 0, event.level};
+    if (event.site == nullptr) {
+        key = SiteKey{nullptr, event.filename, event.function, event.format, event.line, event.level};
+    }
+
+    auto [it, inserted] = sites_.emplace(key, sites_.size());
+    if (inserted) {
+        const char* format = event.Format();
+        AppendType(binary_log::EntryType::kSite, out);
+        AppendVarint(it->second, out);
+        out.Append(static_cast<char>(event.level));
+        out.Append(static_cast<char>(format != nullptr ? binary_log::kSiteHasFormat : 0));
+        AppendBytes(NonNull(event.Filename()), out);
+        AppendBytes(NonNull(event.Function()), out);
+        AppendVarint(static_cast<uint64_t>(event.Line()), out);
+        if (format != nullptr) {
+            AppendBytes(format, out);
+        }
+    }
+    return it->second;
+}
+
+uint64_t BinaryLogEncoder::ModuleId(std::string_view module, FormatBuffer& out) {
+    auto [it, inserted] = modules_.emplace(module.data(), modules_.size());
+    if (inserted) {
+        AppendType(binary_log::EntryType::kModule, out);
+        AppendVarint(it->second, out);
+        AppendBytes(module, out);
+    }
+    return it->second;
+}
+
+bool BinaryLogReader::Next(LogEvent& event) {
+    if (!header_read_ && !ReadHeader()) {
+        return false;
+    }
+
+    for (;;) {
+        int type = input_.get();
+        if (type == std::char_traits<char>::eof()) {
+            return false;
+        }
+        // 多个文件直接拼接时中间会出现文件头
+        if (type == binary_log::kMagic[0]) {
+            input_.unget();
+            if (!ReadHeader()) {
+                return false;
+            }
+            continue;
+        }
+        switch (static_cast<binary_log::EntryType>(type)) {
+            case binary_log::EntryType::kSession:
+                sites_.clear();
+                modules_.clear();
+                last_timestamp_ = 0;
+                break;
+            case binary_log::EntryType::kSite:
+                if (!ReadSite()) {
+                    return false;
+                }
+                break;
+            case binary_log::EntryType::kModule:
+                if (!ReadModule()) {
+                    return false;
+                }
+                break;
+            case binary_log::EntryType::kRecord:
+                return ReadRecord(event);
+            default:
+                return Fail("unknown entry type " + std::to_string(type));
+        }
+    }
+}
+
+bool BinaryLogReader::ReadHeader() {
+    char header[binary_log::kHeaderSize];
+    if (!input_.read(header, sizeof(header))) {
+        // 空文件不是错误
+        return input_.gcount() == 0 ? false : Fail("truncated file header");
+    }
+    if (memcmp(header, binary_log::kMagic, sizeof(binary_log::kMagic)) != 0) {
+        return Fail("not a tinylog binary file");
+    }
+    if (static_cast<uint8_t>(header[sizeof(binary_log::kMagic)]) != binary_log::kVersion) {
+        return Fail("unsupported format version " + std::to_string(static_cast<uint8_t>(header[sizeof(header) - 1])));
+    }
+    header_read_ = true;
+    return true;
+}
+
+bool BinaryLogReader::ReadSite() {
+    uint64_t id;
+    uint64_t line;
+    char level_and_flags[2];
+    auto decoded = std::make_unique<DecodedSite>();
+    if (!ReadVarint(id) || !input_.read(level_and_flags, sizeof(level_and_flags)) ||
+        !ReadString(decoded->filename) || !ReadString(decoded->function) || !ReadVarint(line)) {
+        return Fail("truncated call site");
+    }
+    bool has_format = (level_and_flags[1] & binary_log::kSiteHasFormat) != 0;
+    if (has_format && !ReadString(decoded->format)) {
+        return Fail("truncated call site");
+    }
+    if (static_cast<uint8_t>(level_and_flags[0]) > static_cast<uint8_t>(LogLevel::kFatal)) {
+        return Fail("invalid log level in call site");
+    }
+
+    auto level = static_cast<LogLevel>(level_and_flags[0]);
+    const char* format = has_format ? decoded->format.c_str() : nullptr;
+    decoded->site = CallSite{level, decoded->filename.c_str(), decoded->function.c_str(), static_cast<int>(line), format,
+                             has_format ? ParseFormat(format) : FormatSpec{}, nullptr, 0};
+
+    // 编号按出现顺序分配，会话重新开始后从0重新编号
+    if (id > sites_.size()) {
+        return Fail("call site id out of order");
+    }
+    if (id == sites_.size()) {
+        sites_.push_back(std::move(decoded));
+    } else {
+        sites_[id] = std::move(decoded);
+    }
+    return true;
+}
+
+bool BinaryLogReader::ReadModule() {
+    uint64_t id;
+    std::string name;
+    if (!ReadVarint(id) || !ReadString(name)) {
+        return Fail("truncated module");
+    }
+    if (id > modules_.size()) {
+        return Fail("module id out of order");
+    }
+    if (id == modules_.size()) {
+        modules_.push_back(std::move(name));
+    } else {
+        modules_[id] = std::move(name);
+    }
+    return true;
+}
+
+bool BinaryLogReader::ReadRecord(LogEvent& event) {
+    uint64_t site_id;
+    uint64_t module_id;
+    uint64_t delta;
+    if (!ReadVarint(site_id) || !ReadVarint(module_id) || !ReadVarint(delta) || !ReadString(payload_)) {
+        return Fail("truncated record");
+    }
+    if (site_id >= sites_.size() || !sites_[site_id]) {
+        return Fail("record refers to undefined call site " + std::to_string(site_id));
+    }
+    if (module_id > modules_.size()) {
+        return Fail("record refers to undefined module " + std::to_string(module_id - 1));
+    }
+
+    const CallSite& site = sites_[site_id]->site;
+    last_timestamp_ += ZigZagDecode(delta);
+
+    event.level = site.level;
+    event.timestamp = last_timestamp_;
+    event.filename = site.filename;
+    event.function = site.function;
+    event.line = site.line;
+    event.format = nullptr;
+    event.site = &site;
+    event.module = module_id == 0 ? std::string_view() : std::string_view(modules_[module_id - 1]);
+    event.args.clear();
+    event.message.clear();
+    if (site.format != nullptr) {
+        event.args.Append(payload_.data(), payload_.size());
+    } else {
+        event.message = payload_;
+    }
+    return true;
+}
+
+bool BinaryLogReader::ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = input_.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::ReadString(std::string& value) {
+    uint64_t length;
+    // 长度异常时视为数据损坏，避免按错误的长度分配内存
+    if (!ReadVarint(length) || length > kMaxStringLength) {
+        return false;
+    }
+    value.resize(length);
+    return length == 0 || input_.read(value.data(), static_cast<std::streamsize>(length));
+}
+
+bool BinaryLogReader::Fail(const std::string& reason) {
+    error_ = reason;
+    return false;
+}
+
+}  // namespace tinylog::internal
@@ -0,0 +1,248 @@
+#include "tinylog/internal/config_watcher.h"
+
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace tinylog::internal {
+
+ConfigWatcher& ConfigWatcher::GetInstance() {
+    // 有意不释放：日志实例在静态对象析构期间仍会取消监控
+    static ConfigWatcher* instance = new ConfigWatcher();
+    return *instance;
+}
+
+ConfigWatcher::ConfigWatcher() {
+#ifdef __linux__
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotify_fd_ < 0 || wake_fd_ < 0) {
+        fprintf(stderr, "Failed to initialize inotify (%s), falling back to polling config files\n",
+                strerror(errno));
+        if (inotify_fd_ >= 0) {
+            close(inotify_fd_);
+        }
+        if (wake_fd_ >= 0) {
+            close(wake_fd_);
+        }
+        inotify_fd_ = -1;
+        wake_fd_ = -1;
+    }
+#endif
+}
+
+uint64_t ConfigWatcher::Watch(const std::string& file_path, Callback callback) {
+    std::filesystem::path path(file_path);
+    WatchEntry entry;
+    entry.directory = path.has_parent_path() ? path.parent_path().string() : ".";
+    entry.file_name = path.filename().string();
+    entry.file_path = file_path;
+    entry.stamp = GetFileStamp(file_path);
+    entry.callback = std::move(callback);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        // 监控目录而不是文件本身，文件被rename替换后仍能收到事件
+        entry.watch_descriptor =
+            inotify_add_watch(inotify_fd_, entry.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (entry.watch_descriptor >= 0) {
+            ++descriptor_refs_[entry.watch_descriptor];
+        } else {
+            fprintf(stderr, "Failed to watch %s (%s), polling instead\n", entry.directory.c_str(), strerror(errno));
+        }
+    }
+#endif
+    if (entry.watch_descriptor < 0) {
+        ++polled_count_;
+    }
+
+    uint64_t id = next_id_++;
+    watches_.emplace(id, std::move(entry));
+
+    if (!started_) {
+        started_ = true;
+        std::thread worker(&ConfigWatcher::Run, this);
+        worker_id_ = worker.get_id();
+        worker.detach();
+    } else {
+        WakeUp();
+    }
+    return id;
+}
+
+void ConfigWatcher::Unwatch(uint64_t id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = watches_.find(id);
+    if (it == watches_.end()) {
+        return;
+    }
+
+    int descriptor = it->second.watch_descriptor;
+    if (descriptor >= 0) {
+        auto ref = descriptor_refs_.find(descriptor);
+        if (ref != descriptor_refs_.end() && --ref->second == 0) {
+#ifdef __linux__
+            inotify_rm_watch(inotify_fd_, descriptor);
+#endif
+            descriptor_refs_.erase(ref);
+        }
+    } else {
+        --polled_count_;
+    }
+    watches_.erase(it);
+    pending_.erase(id);
+
+    // 回调正在执行时等待其结束，在回调中取消监控时不能等待自己
+    if (std::this_thread::get_id() != worker_id_) {
+        callback_cv_.wait(lock, [this, id] { return running_id_ != id; });
+    }
+}
+
+ConfigWatcher::FileStamp ConfigWatcher::GetFileStamp(const std::string& file_path) {
+    FileStamp stamp;
+    struct stat file_stat;
+    if (stat(file_path.c_str(), &file_stat) == 0) {
+        stamp.inode = file_stat.st_ino;
+        stamp.size = file_stat.st_size;
+#ifdef __linux__
+        stamp.mtime_ns = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+#else
+        stamp.mtime_ns = static_cast<int64_t>(file_stat.st_mtime) * 1000000000;
+#endif
+    }
+    return stamp;
+}
+
+void ConfigWatcher::Run() {
+    for (;;) {
+        bool polling = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            polling = inotify_fd_ < 0 || polled_count_ > 0;
+        }
+
+        if (inotify_fd_ >= 0) {
+            // 等待inotify事件或唤醒，有轮询的监控项时按轮询间隔超时
+            struct pollfd fds[2];
+            fds[0].fd = inotify_fd_;
+            fds[0].events = POLLIN;
+            fds[1].fd = wake_fd_;
+            fds[1].events = POLLIN;
+            int timeout = polling ? static_cast<int>(kPollInterval.count()) : -1;
+            int ret = poll(fds, 2, timeout);
+            if (ret < 0 && errno != EINTR) {
+                fprintf(stderr, "Failed to wait for config file events: %s\n", strerror(errno));
+                std::this_thread::sleep_for(kPollInterval);
+            }
+            if (ret > 0 && (fds[1].revents & POLLIN) != 0) {
+                uint64_t value = 0;
+                ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+                static_cast<void>(ignored);
+            }
+            if (ret > 0 && (fds[0].revents & POLLIN) != 0) {
+                ReadEvents();
+            }
+        } else {
+            std::unique_lock<std::mutex> lock(mutex_);
+            poll_cv_.wait_for(lock, kPollInterval);
+        }
+
+        CheckWatches();
+    }
+}
+
+void ConfigWatcher::ReadEvents() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ssize_t offset = 0; offset < length;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            if (event->len == 0) {
+                continue;
+            }
+            for (const auto& [id, entry] : watches_) {
+                if (entry.watch_descriptor == event->wd && entry.file_name == event->name) {
+                    pending_.insert(id);
+                }
+            }
+        }
+    }
+#endif
+}
+
+void ConfigWatcher::CheckWatches() {
+    // 文件状态确实变化的监控项，回调在释放锁之后调用
+    std::vector<std::pair<uint64_t, Callback>> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, entry] : watches_) {
+            bool notified = pending_.count(id) != 0;
+            if (entry.watch_descriptor >= 0 && !notified) {
+                continue;
+            }
+            // 收到写入完成事件时总是重新加载（文件时间戳的精度可能不足以区分两次写入），
+            // 轮询时只在文件状态变化后重新加载；文件暂时不存在（例如正在被替换）时等待下一次检查
+            FileStamp stamp = GetFileStamp(entry.file_path);
+            if (stamp.size >= 0 && (notified || stamp != entry.stamp)) {
+                entry.stamp = stamp;
+                changed.emplace_back(id, entry.callback);
+            }
+        }
+        pending_.clear();
+    }
+
+    for (auto& [id, callback] : changed) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (watches_.count(id) == 0) {
+                continue;
+            }
+            running_id_ = id;
+        }
+
+        try {
+            callback();
+        } catch (const std::exception& e) {
+            fprintf(stderr, "Failed to reload config file: %s\n", e.what());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_id_ = 0;
+        }
+        callback_cv_.notify_all();
+    }
+}
+
+void ConfigWatcher::WakeUp() {
+    if (wake_fd_ >= 0) {
+        uint64_t value = 1;
+        ssize_t ignored = write(wake_fd_, &value, sizeof(value));
+        static_cast<void>(ignored);
+    } else {
+        poll_cv_.notify_one();
+    }
+}
+
+}  // namespace tinylog::internal
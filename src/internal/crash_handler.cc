@@ -0,0 +1,427 @@
+#include "tinylog/internal/crash_handler.h"
+
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "tinylog/internal/async_writer.h"
+#include "tinylog/internal/log_utils.h"
+#include "tinylog/internal/sink_interface.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+// 可登记的sink和异步写入器的最大数量，超出的对象在崩溃时不会被写出
+constexpr size_t kMaxCrashTargets = 256;
+
+// 调用栈的最大深度
+constexpr int kMaxStackFrames = 64;
+
+// 崩溃处理中获取锁的最长等待时间
+constexpr int kLockWaitMs = 200;
+
+// 处理的信号
+constexpr int kCrashSignals[] = {SIGSEGV, SIGABRT, SIGBUS};
+constexpr size_t kCrashSignalCount = sizeof(kCrashSignals) / sizeof(kCrashSignals[0]);
+
+// 每个线程的信号处理函数备用栈大小
+constexpr size_t kAltStackSize = 64 * 1024;
+
+// 崩溃处理中编码单条日志的最大长度
+constexpr size_t kMaxCrashRecordSize = 64 * 1024;
+
+// 登记表：固定大小的原子指针数组，登记时占用空位，注销时清空，崩溃处理中无锁遍历
+template <typename T>
+class CrashTargets {
+public:
+    void Add(T* target) noexcept {
+        for (auto& slot : slots_) {
+            T* expected = nullptr;
+            if (slot.compare_exchange_strong(expected, target)) {
+                return;
+            }
+        }
+    }
+
+    void Remove(T* target) noexcept;
+
+    template <typename Function>
+    void ForEach(Function&& function) noexcept {
+        for (auto& slot : slots_) {
+            T* target = slot.load();
+            if (target != nullptr) {
+                function(*target);
+            }
+        }
+    }
+
+private:
+    std::atomic<T*> slots_[kMaxCrashTargets]{};
+};
+
+CrashTargets<SinkInterface> g_sinks;
+CrashTargets<AsyncWriter> g_writers;
+
+std::atomic<bool> g_installed{false};
+struct sigaction g_previous_actions[kCrashSignalCount];
+
+// 正在进行崩溃处理的线程，0表示没有
+std::atomic<pid_t> g_crash_thread{0};
+
+// 崩溃处理中已查询过的sink及其文件描述符，只由崩溃处理线程访问
+SinkInterface* g_fd_sinks[kMaxCrashTargets];
+int g_fd_values[kMaxCrashTargets];
+size_t g_fd_count = 0;
+
+pid_t CurrentThreadId() noexcept { return static_cast<pid_t>(::syscall(SYS_gettid)); }
+
+void SleepMs(long ms) noexcept {
+    struct timespec duration = {0, ms * 1000000};
+    ::nanosleep(&duration, nullptr);
+}
+
+// 其他线程已在进行崩溃处理时等待其终止进程
+[[noreturn]] void WaitForever() noexcept {
+    for (;;) {
+        ::pause();
+    }
+}
+
+template <typename T>
+void CrashTargets<T>::Remove(T* target) noexcept {
+    for (auto& slot : slots_) {
+        if (slot.load() == target) {
+            slot.store(nullptr);
+            break;
+        }
+    }
+    // 与崩溃处理线程的先设置标记、后遍历登记表相对应：清空后若看到标记，对象可能正被访问，不能返回
+    pid_t crash_thread = g_crash_thread.load();
+    if (crash_thread != 0 && crash_thread != CurrentThreadId()) {
+        WaitForever();
+    }
+}
+
+enum class CrashOwner { kFirst, kSameThread, kOtherThread };
+
+// 标记崩溃处理开始，只有第一个线程执行崩溃处理
+CrashOwner BeginCrash() noexcept {
+    pid_t self = CurrentThreadId();
+    pid_t expected = 0;
+    if (g_crash_thread.compare_exchange_strong(expected, self)) {
+        return CrashOwner::kFirst;
+    }
+    return expected == self ? CrashOwner::kSameThread : CrashOwner::kOtherThread;
+}
+
+void WriteString(int fd, const char* text) noexcept { CrashWrite(fd, text, strlen(text)); }
+
+// 调用方可能传入空的文件名或函数名，与格式化器一样输出为(null)
+std::string_view NonNull(const char* str) noexcept { return str != nullptr ? std::string_view(str) : "(null)"; }
+
+// 按十进制追加无符号整数，位数不足min_digits时在前面补零。snprintf不是异步信号安全的
+void AppendDecimal(FixedBuffer& out, uint64_t value, size_t min_digits = 1) noexcept {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0 || count < min_digits);
+    while (count > 0) {
+        out.Append(digits[--count]);
+    }
+}
+
+// 线程的备用栈：首次准备时分配并安装，线程退出时停用并释放。线程已有备用栈时不做修改
+class AltStack {
+public:
+    AltStack() = default;
+    ~AltStack() {
+        if (memory_ != nullptr) {
+            stack_t disabled = {};
+            disabled.ss_flags = SS_DISABLE;
+            ::sigaltstack(&disabled, nullptr);
+            std::free(memory_);
+        }
+    }
+
+    AltStack(const AltStack&) = delete;
+    AltStack& operator=(const AltStack&) = delete;
+
+    void Install() noexcept {
+        if (prepared_) {
+            return;
+        }
+        prepared_ = true;
+        stack_t current_stack;
+        if (::sigaltstack(nullptr, &current_stack) != 0 || (current_stack.ss_flags & SS_DISABLE) == 0) {
+            return;
+        }
+        memory_ = std::malloc(kAltStackSize);
+        if (memory_ == nullptr) {
+            return;
+        }
+        stack_t alt_stack = {};
+        alt_stack.ss_sp = memory_;
+        alt_stack.ss_size = kAltStackSize;
+        if (::sigaltstack(&alt_stack, nullptr) != 0) {
+            std::free(memory_);
+            memory_ = nullptr;
+        }
+    }
+
+private:
+    void* memory_ = nullptr;
+    bool prepared_ = false;
+};
+
+thread_local AltStack t_alt_stack;
+
+const char* SignalName(int sig) noexcept {
+    switch (sig) {
+        case SIGSEGV:
+            return "SIGSEGV";
+        case SIGABRT:
+            return "SIGABRT";
+        case SIGBUS:
+            return "SIGBUS";
+        default:
+            return "signal";
+    }
+}
+
+// 写出崩溃原因和调用栈：标准错误输出，以及崩溃处理中查询过的各文件（控制台除外）
+void WriteCrashReport(const char* reason, int sig) noexcept {
+    void* frames[kMaxStackFrames];
+    int frame_count = ::backtrace(frames, kMaxStackFrames);
+
+    char number_storage[24];
+    FixedBuffer number(number_storage, sizeof(number_storage));
+    AppendDecimal(number, static_cast<uint64_t>(sig));
+
+    int fds[kMaxCrashTargets + 1];
+    size_t fd_count = 0;
+    fds[fd_count++] = STDERR_FILENO;
+    for (size_t i = 0; i < g_fd_count; ++i) {
+        int fd = g_fd_values[i];
+        bool seen = fd < 0 || fd == STDOUT_FILENO;
+        for (size_t j = 0; j < fd_count && !seen; ++j) {
+            seen = fds[j] == fd;
+        }
+        if (!seen) {
+            fds[fd_count++] = fd;
+        }
+    }
+
+    for (size_t i = 0; i < fd_count; ++i) {
+        WriteString(fds[i], "*** tinylog: ");
+        WriteString(fds[i], reason);
+        if (sig != 0) {
+            WriteString(fds[i], " ");
+            CrashWrite(fds[i], number.data(), number.size());
+            WriteString(fds[i], " (");
+            WriteString(fds[i], SignalName(sig));
+            WriteString(fds[i], ")");
+        }
+        WriteString(fds[i], ", stack trace: ***\n");
+        ::backtrace_symbols_fd(frames, frame_count, fds[i]);
+    }
+}
+
+// 在信号处理函数中写出所有日志：标准输出的stdio缓冲区、各文件sink的缓冲区，再写出各异步队列中的日志
+void FlushForSignal() noexcept {
+    // stdio的锁可能被崩溃的线程持有，获取不到时放弃
+    if (::ftrylockfile(stdout) == 0) {
+        ::fflush_unlocked(stdout);
+        ::funlockfile(stdout);
+    }
+    g_sinks.ForEach([](SinkInterface& sink) { CrashSinkFd(sink); });
+    g_writers.ForEach([](AsyncWriter& writer) { writer.CrashDrain(); });
+}
+
+void SignalHandler(int sig, siginfo_t* info, void* context) {
+    int saved_errno = errno;
+    switch (BeginCrash()) {
+        case CrashOwner::kFirst:
+            FlushForSignal();
+            WriteCrashReport("received signal", sig);
+            break;
+        case CrashOwner::kSameThread:
+            // 崩溃处理本身出错，不再重复处理
+            break;
+        case CrashOwner::kOtherThread:
+            WaitForever();
+    }
+
+    // 恢复安装前的处理方式后重新触发，返回后信号解除阻塞并按原方式处理（默认为终止进程并生成core文件）
+    for (size_t i = 0; i < kCrashSignalCount; ++i) {
+        if (kCrashSignals[i] == sig) {
+            ::sigaction(sig, &g_previous_actions[i], nullptr);
+        }
+    }
+    errno = saved_errno;
+    ::raise(sig);
+}
+
+}  // namespace
+
+void RegisterCrashSink(SinkInterface* sink) noexcept { g_sinks.Add(sink); }
+
+void UnregisterCrashSink(SinkInterface* sink) noexcept { g_sinks.Remove(sink); }
+
+void RegisterCrashWriter(AsyncWriter* writer) noexcept { g_writers.Add(writer); }
+
+void UnregisterCrashWriter(AsyncWriter* writer) noexcept { g_writers.Remove(writer); }
+
+void InstallCrashHandler() {
+    if (g_installed.exchange(true)) {
+        PrepareCrashThread();
+        return;
+    }
+
+    // backtrace首次调用时会加载libgcc并分配内存，提前调用一次，信号处理函数中的调用不再分配内存
+    void* frame = nullptr;
+    ::backtrace(&frame, 1);
+    PrepareCrashThread();
+
+    struct sigaction action = {};
+    action.sa_sigaction = SignalHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < kCrashSignalCount; ++i) {
+        ::sigaction(kCrashSignals[i], &action, &g_previous_actions[i]);
+    }
+}
+
+void HandleFatal() {
+    if (!g_installed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    switch (BeginCrash()) {
+        case CrashOwner::kFirst:
+            break;
+        case CrashOwner::kSameThread:
+            return;
+        case CrashOwner::kOtherThread:
+            WaitForever();
+    }
+
+    // 进程状态正常，按正常路径等待异步队列写完并刷新各sink
+    fflush(stdout);
+    g_writers.ForEach([](AsyncWriter& writer) { writer.Flush(); });
+    g_sinks.ForEach([](SinkInterface& sink) {
+        sink.flush();
+        CrashSinkFd(sink);
+    });
+    WriteCrashReport("fatal log record", 0);
+
+    // abort触发的SIGABRT按安装前的方式处理，不再重复崩溃处理
+    for (size_t i = 0; i < kCrashSignalCount; ++i) {
+        if (kCrashSignals[i] == SIGABRT) {
+            ::sigaction(SIGABRT, &g_previous_actions[i], nullptr);
+        }
+    }
+    std::abort();
+}
+
+bool CrashTryLock(std::mutex& mutex) noexcept {
+    // std::mutex::try_lock即pthread_mutex_trylock，对普通互斥量只是一次原子操作
+    for (int i = 0; i < kLockWaitMs; ++i) {
+        if (mutex.try_lock()) {
+            return true;
+        }
+        SleepMs(1);
+    }
+    return false;
+}
+
+void CrashWrite(int fd, const char* data, size_t size, off_t offset) noexcept {
+    while (size > 0) {
+        ssize_t written = offset < 0 ? ::write(fd, data, size) : ::pwrite(fd, data, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        if (offset >= 0) {
+            offset += written;
+        }
+    }
+}
+
+int CrashSinkFd(SinkInterface& sink) noexcept {
+    for (size_t i = 0; i < g_fd_count; ++i) {
+        if (g_fd_sinks[i] == &sink) {
+            return g_fd_values[i];
+        }
+    }
+    int fd = sink.crashFlush();
+    if (g_fd_count < kMaxCrashTargets) {
+        g_fd_sinks[g_fd_count] = &sink;
+        g_fd_values[g_fd_count] = fd;
+        ++g_fd_count;
+    }
+    return fd;
+}
+
+void PrepareCrashThread() noexcept {
+    if (g_installed.load(std::memory_order_relaxed)) {
+        t_alt_stack.Install();
+    }
+}
+
+std::string_view CrashFormatEvent(const LogEvent& event) noexcept {
+    static char storage[kMaxCrashRecordSize];
+    // 留出一个字节，截断时仍以换行结尾
+    FixedBuffer out(storage, sizeof(storage) - 1);
+
+    // 时间戳原样输出为秒和纳秒，不做时区转换
+    uint64_t timestamp = event.timestamp < 0 ? 0 : static_cast<uint64_t>(event.timestamp);
+    out.Append('[');
+    AppendDecimal(out, timestamp / 1000000000);
+    out.Append('.');
+    AppendDecimal(out, timestamp % 1000000000, 9);
+    out.Append(std::string_view("] ["));
+    out.Append(std::string_view(LogLevelToString(event.level)));
+    out.Append(std::string_view("] "));
+    if (!event.module.empty()) {
+        out.Append('[');
+        out.Append(event.module);
+        out.Append(std::string_view("] "));
+    }
+    out.Append(NonNull(event.Filename()));
+    out.Append(':');
+    out.Append(NonNull(event.Function()));
+    out.Append(':');
+    int line = event.Line();
+    AppendDecimal(out, line < 0 ? 0 : static_cast<uint64_t>(line));
+    out.Append(std::string_view(" - "));
+
+    const char* format = event.Format();
+    if (format != nullptr) {
+        FormatArgs(format, event.args, out);
+    } else {
+        out.Append(event.message);
+    }
+    if (!event.args.empty()) {
+        AppendTextFields(event.args, out);
+    }
+
+    storage[out.size()] = '\n';
+    return std::string_view(storage, out.size() + 1);
+}
+
+}  // namespace tinylog::internal
@@ -0,0 +1,18 @@
+#include "tinylog/internal/epoch.h"
+
+#include <thread>
+
+namespace tinylog::internal {
+
+void EpochDomain::Synchronize() noexcept {
+    // 翻转两次纪元，依次等待两个计数器归零：第一次等待持有旧纪元奇偶的读取方，
+    // 第二次等待在更早的纪元读取了奇偶、可能仍持有旧数据的读取方
+    for (int i = 0; i < 2; ++i) {
+        uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        while (readers_[epoch & 1].count.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}  // namespace tinylog::internal
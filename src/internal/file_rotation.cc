@@ -0,0 +1,251 @@
+#include "tinylog/internal/file_rotation.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef TINYLOG_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace tinylog::internal {
+
+namespace {
+
+// 目录中的一个备份文件
+struct BackupFile {
+    std::filesystem::path path;
+    std::string label;  // 按大小滚动时为序号，按时间滚动时为时间段标签
+    uint64_t seq = 0;   // 按大小滚动时为序号，按时间滚动时为同一时间段内的序号
+    uintmax_t size = 0;
+};
+
+bool HasSuffix(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool FileExists(const std::string& path) { return ::access(path.c_str(), F_OK) == 0; }
+
+// 解析备份文件名中文件名之后的部分，格式为"<label>[.<seq>][.gz]"
+bool ParseBackupName(std::string rest, RotationMode mode, BackupFile& backup) {
+    if (HasSuffix(rest, ".gz")) {
+        rest.resize(rest.size() - 3);
+    }
+    if (rest.empty() || rest[0] < '0' || rest[0] > '9' || rest.find(".rotating.") != std::string::npos) {
+        return false;
+    }
+
+    size_t dot = rest.find('.');
+    backup.label = rest.substr(0, dot);
+    std::string seq = dot == std::string::npos ? "" : rest.substr(dot + 1);
+    if (backup.label.find_first_not_of("0123456789-") != std::string::npos ||
+        seq.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    if (mode == RotationMode::kSize) {
+        if (!seq.empty() || backup.label.find('-') != std::string::npos) {
+            return false;
+        }
+        backup.seq = std::stoull(backup.label);
+    } else {
+        backup.seq = seq.empty() ? 0 : std::stoull(seq);
+    }
+    return true;
+}
+
+// 列出所有备份文件，按从新到旧排序
+std::vector<BackupFile> ListBackupFiles(const std::string& file_path, RotationMode mode) {
+    std::filesystem::path path(file_path);
+    std::filesystem::path dir = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    std::string prefix = path.filename().string() + ".";
+
+    std::vector<BackupFile> backups;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+
+        BackupFile backup;
+        if (!ParseBackupName(name.substr(prefix.size()), mode, backup)) {
+            continue;
+        }
+        backup.path = it->path();
+        std::error_code size_ec;
+        backup.size = std::filesystem::file_size(backup.path, size_ec);
+        backups.push_back(std::move(backup));
+    }
+
+    if (mode == RotationMode::kSize) {
+        // 序号越小越新
+        std::sort(backups.begin(), backups.end(),
+                  [](const BackupFile& lhs, const BackupFile& rhs) { return lhs.seq < rhs.seq; });
+    } else {
+        // 时间段越晚越新，同一时间段内序号越大越新
+        std::sort(backups.begin(), backups.end(), [](const BackupFile& lhs, const BackupFile& rhs) {
+            return lhs.label != rhs.label ? lhs.label > rhs.label : lhs.seq > rhs.seq;
+        });
+    }
+    return backups;
+}
+
+// 按大小滚动时备份文件逐级后移（file.1 -> file.2 ...），压缩过的备份一同后移
+void ShiftBackupFiles(const std::string& file_path, int32_t max_file_count) {
+    for (int32_t i = max_file_count - 1; i > 0; --i) {
+        std::string old_file = file_path + "." + std::to_string(i);
+        std::string new_file = file_path + "." + std::to_string(i + 1);
+        ::rename(old_file.c_str(), new_file.c_str());
+        ::rename((old_file + ".gz").c_str(), (new_file + ".gz").c_str());
+    }
+}
+
+// 按时间滚动时的备份文件名，同一时间段内多次滚动时追加序号
+std::string GetPeriodBackupName(const std::string& file_path, const std::string& period_label) {
+    std::string backup_file = file_path + "." + period_label;
+    for (int seq = 1; FileExists(backup_file) || FileExists(backup_file + ".gz"); ++seq) {
+        backup_file = file_path + "." + period_label + "." + std::to_string(seq);
+    }
+    return backup_file;
+}
+
+}  // namespace
+
+RotationPeriod GetRotationPeriod(RotationMode mode, int64_t timestamp_ns) {
+    if (mode == RotationMode::kSize) {
+        return RotationPeriod{"", std::numeric_limits<int64_t>::max()};
+    }
+
+    time_t seconds = static_cast<time_t>(timestamp_ns / 1000000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    if (mode == RotationMode::kDaily) {
+        local.tm_hour = 0;
+    }
+
+    char label[32];
+    strftime(label, sizeof(label), mode == RotationMode::kDaily ? "%Y%m%d" : "%Y%m%d-%H", &local);
+
+    // 由mktime处理跨月和夏令时切换
+    if (mode == RotationMode::kDaily) {
+        local.tm_mday += 1;
+    } else {
+        local.tm_hour += 1;
+    }
+    local.tm_isdst = -1;
+    time_t end = mktime(&local);
+    return RotationPeriod{label, static_cast<int64_t>(end) * 1000000000};
+}
+
+bool IsCompressionSupported() {
+#ifdef TINYLOG_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CompressFile(const std::string& source_file, const std::string& target_file) {
+#ifdef TINYLOG_HAVE_ZLIB
+    int source_fd = ::open(source_file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (source_fd < 0) {
+        return false;
+    }
+
+    // 先写入临时文件，压缩完成后再改名，避免留下不完整的压缩文件
+    std::string temp_file = target_file + ".tmp";
+    gzFile target = gzopen(temp_file.c_str(), "wb6");
+    if (target == nullptr) {
+        ::close(source_fd);
+        return false;
+    }
+
+    bool success = true;
+    std::vector<char> buffer(64 * 1024);
+    for (;;) {
+        ssize_t bytes = ::read(source_fd, buffer.data(), buffer.size());
+        if (bytes == 0) {
+            break;
+        }
+        if (bytes < 0 || gzwrite(target, buffer.data(), static_cast<unsigned>(bytes)) != bytes) {
+            success = false;
+            break;
+        }
+    }
+    ::close(source_fd);
+    success = gzclose(target) == Z_OK && success;
+
+    if (!success || ::rename(temp_file.c_str(), target_file.c_str()) != 0) {
+        fprintf(stderr, "Failed to compress log file: %s\n", source_file.c_str());
+        ::unlink(temp_file.c_str());
+        return false;
+    }
+    ::unlink(source_file.c_str());
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ArchiveRotatedFile(const std::string& file_path, const std::string& pending_file,
+                        const std::string& period_label, const RotationPolicy& policy) {
+    std::string backup_file;
+    if (policy.mode == RotationMode::kSize) {
+        ShiftBackupFiles(file_path, policy.max_file_count);
+        backup_file = file_path + ".1";
+    } else {
+        backup_file = GetPeriodBackupName(file_path, period_label);
+    }
+
+    if (::rename(pending_file.c_str(), backup_file.c_str()) != 0) {
+        fprintf(stderr, "Failed to rename rotated log file: %s\n", pending_file.c_str());
+        return;
+    }
+
+    if (policy.compress) {
+        CompressFile(backup_file, backup_file + ".gz");
+    }
+    EnforceRetention(file_path, policy);
+}
+
+void EnforceRetention(const std::string& file_path, const RotationPolicy& policy) {
+    std::vector<BackupFile> backups = ListBackupFiles(file_path, policy.mode);
+
+    // 超出数量的备份从最旧的开始删除
+    std::error_code ec;
+    size_t keep = static_cast<size_t>(std::max(policy.max_file_count, 0));
+    while (backups.size() > keep) {
+        std::filesystem::remove(backups.back().path, ec);
+        backups.pop_back();
+    }
+
+    if (policy.max_total_size == 0) {
+        return;
+    }
+
+    uintmax_t total_size = std::filesystem::file_size(file_path, ec);
+    if (ec) {
+        total_size = 0;
+    }
+    for (const auto& backup : backups) {
+        total_size += backup.size;
+    }
+    while (total_size > policy.max_total_size && !backups.empty()) {
+        total_size -= backups.back().size;
+        std::filesystem::remove(backups.back().path, ec);
+        backups.pop_back();
+    }
+}
+
+}  // namespace tinylog::internal
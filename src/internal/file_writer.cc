@@ -0,0 +1,206 @@
+#include "tinylog/internal/file_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef TINYLOG_HAVE_IO_URING
+#include <liburing.h>
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace tinylog::internal {
+
+bool WriteFully(int fd, struct iovec* iov, int count, off_t offset) {
+    while (count > 0) {
+        ssize_t written = offset < 0 ? ::writev(fd, iov, count) : ::pwritev(fd, iov, count, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Failed to write to log file: %s\n", strerror(errno));
+            return false;
+        }
+        if (offset >= 0) {
+            offset += written;
+        }
+
+        // 处理部分写入，跳过已写完的部分
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+// 将buffer和extra同步写入文件
+void WriteSync(int fd, std::vector<char>& buffer, std::string_view extra, off_t offset) {
+    struct iovec iov[2];
+    iov[0].iov_base = buffer.data();
+    iov[0].iov_len = buffer.size();
+    iov[1].iov_base = const_cast<char*>(extra.data());
+    iov[1].iov_len = extra.size();
+    WriteFully(fd, iov, extra.empty() ? 1 : 2, offset);
+    buffer.clear();
+}
+
+}  // namespace
+
+// WritevFileWriter implementation
+int WritevFileWriter::openFlags() const { return O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC; }
+
+void WritevFileWriter::write(int fd, std::vector<char>& buffer, std::string_view extra, size_t offset) {
+    // 以追加方式打开，无需偏移量
+    WriteSync(fd, buffer, extra, -1);
+}
+
+// UringFileWriter implementation
+struct UringFileWriter::Impl {
+#ifdef TINYLOG_HAVE_IO_URING
+    // 一块在途的缓冲区
+    struct Slot {
+        std::vector<char> buffer;
+        int fd = -1;
+        size_t offset = 0;
+        bool busy = false;
+    };
+
+    // 收割已完成的写入请求，wait为true时至少等待一个请求完成
+    void Reap(bool wait) {
+        struct io_uring_cqe* cqe = nullptr;
+        int ret = wait ? io_uring_wait_cqe(&ring, &cqe) : io_uring_peek_cqe(&ring, &cqe);
+        while (ret == -EINTR && wait) {
+            ret = io_uring_wait_cqe(&ring, &cqe);
+        }
+
+        while (ret == 0 && cqe != nullptr) {
+            Slot* slot = static_cast<Slot*>(io_uring_cqe_get_data(cqe));
+            int result = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+
+            // 失败或部分写入时同步补写剩余部分
+            size_t written = result > 0 ? static_cast<size_t>(result) : 0;
+            if (result < 0 && result != -EAGAIN && result != -EINTR) {
+                fprintf(stderr, "Failed to write to log file: %s\n", strerror(-result));
+            } else if (written < slot->buffer.size()) {
+                struct iovec iov;
+                iov.iov_base = slot->buffer.data() + written;
+                iov.iov_len = slot->buffer.size() - written;
+                WriteFully(slot->fd, &iov, 1, static_cast<off_t>(slot->offset + written));
+            }
+
+            slot->buffer.clear();
+            slot->busy = false;
+            --in_flight;
+            ret = io_uring_peek_cqe(&ring, &cqe);
+        }
+    }
+
+    struct io_uring ring;
+    bool ring_ready = false;
+    Slot slots[kQueueDepth];
+    unsigned in_flight = 0;
+#endif
+};
+
+UringFileWriter::UringFileWriter(size_t buffer_size) : impl_(std::make_unique<Impl>()) {
+#ifdef TINYLOG_HAVE_IO_URING
+    int ret = io_uring_queue_init(kQueueDepth, &impl_->ring, 0);
+    impl_->ring_ready = ret == 0;
+    if (!impl_->ring_ready) {
+        fprintf(stderr, "Failed to initialize io_uring (%s), falling back to pwritev\n", strerror(-ret));
+    }
+    for (auto& slot : impl_->slots) {
+        slot.buffer.reserve(buffer_size);
+    }
+#else
+    static_cast<void>(buffer_size);
+#endif
+}
+
+UringFileWriter::~UringFileWriter() {
+    wait();
+#ifdef TINYLOG_HAVE_IO_URING
+    if (impl_->ring_ready) {
+        io_uring_queue_exit(&impl_->ring);
+    }
+#endif
+}
+
+int UringFileWriter::openFlags() const {
+    // 按偏移量写入，多个在途请求的完成顺序不影响文件内容
+    return O_WRONLY | O_CREAT | O_CLOEXEC;
+}
+
+void UringFileWriter::write(int fd, std::vector<char>& buffer, std::string_view extra, size_t offset) {
+#ifdef TINYLOG_HAVE_IO_URING
+    if (impl_->ring_ready) {
+        buffer.insert(buffer.end(), extra.begin(), extra.end());
+
+        // 所有缓冲区都在途时才等待
+        while (impl_->in_flight == kQueueDepth) {
+            impl_->Reap(true);
+        }
+        Impl::Slot* slot = nullptr;
+        for (auto& candidate : impl_->slots) {
+            if (!candidate.busy) {
+                slot = &candidate;
+                break;
+            }
+        }
+
+        // 换出缓冲区后立即返回，调用方继续使用换回的空缓冲区
+        slot->buffer.swap(buffer);
+        slot->fd = fd;
+        slot->offset = offset;
+        slot->busy = true;
+
+        struct io_uring_sqe* sqe = io_uring_get_sqe(&impl_->ring);
+        io_uring_prep_write(sqe, fd, slot->buffer.data(), static_cast<unsigned>(slot->buffer.size()), offset);
+        io_uring_sqe_set_data(sqe, slot);
+        io_uring_submit(&impl_->ring);
+        ++impl_->in_flight;
+
+        impl_->Reap(false);
+        return;
+    }
+#endif
+    WriteSync(fd, buffer, extra, static_cast<off_t>(offset));
+}
+
+void UringFileWriter::wait() {
+#ifdef TINYLOG_HAVE_IO_URING
+    while (impl_->in_flight > 0) {
+        impl_->Reap(true);
+    }
+#endif
+}
+
+bool UringFileWriter::isUringActive() const noexcept {
+#ifdef TINYLOG_HAVE_IO_URING
+    return impl_->ring_ready;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<FileWriter> CreateFileWriter(FileEngine engine, size_t buffer_size) {
+    if (engine == FileEngine::kIoUring) {
+        return std::make_unique<UringFileWriter>(buffer_size);
+    }
+    return std::make_unique<WritevFileWriter>();
+}
+
+}  // namespace tinylog::internal
@@ -0,0 +1,107 @@
+#include "tinylog/internal/formatter.h"
+
+#include <charconv>
+#include <string_view>
+
+#include "tinylog/internal/json.h"
+#include "tinylog/internal/log_utils.h"
+#include "tinylog/internal/sink_interface.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+// 追加日志内容，延迟格式化的日志直接把参数展开到输出缓冲区
+void AppendMessage(const LogEvent& event, FormatBuffer& out) {
+    if (event.site != nullptr && event.site->format != nullptr) {
+        FormatArgs(*event.site, event.args, out);
+    } else if (event.format != nullptr) {
+        FormatArgs(event.format, event.args, out);
+    } else {
+        out.Append(event.message);
+    }
+}
+
+// 调用方可能传入空的文件名或函数名，与snprintf("%s")一样输出为(null)
+std::string_view NonNull(const char* str) { return str != nullptr ? std::string_view(str) : "(null)"; }
+
+void AppendLine(int line, FormatBuffer& out) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), line);
+    out.Append(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+}  // namespace
+
+void TextFormatter::format(const LogEvent& event, FormatBuffer& out) const {
+    out.clear();
+
+    // 使用日志事件的捕获时间，而不是格式化时的时间
+    char timestamp[kMaxTimestampLength];
+    size_t timestamp_length = FormatTimestamp(event.timestamp, timestamp_precision_, timestamp);
+
+    out.Append('[');
+    out.Append(timestamp, timestamp_length);
+    out.Append(std::string_view("] ["));
+    out.Append(std::string_view(LogLevelToString(event.level)));
+    out.Append(std::string_view("] "));
+    if (!event.module.empty()) {
+        out.Append('[');
+        out.Append(event.module);
+        out.Append(std::string_view("] "));
+    }
+    out.Append(NonNull(event.Filename()));
+    out.Append(':');
+    out.Append(NonNull(event.Function()));
+    out.Append(':');
+    AppendLine(event.Line(), out);
+    out.Append(std::string_view(" - "));
+
+    AppendMessage(event, out);
+    if (!event.args.empty()) {
+        AppendTextFields(event.args, out);
+    }
+    out.Append('\n');
+}
+
+void JsonFormatter::format(const LogEvent& event, FormatBuffer& out) const {
+    out.clear();
+
+    // 时间戳、级别和行号不含需要转义的字符
+    char timestamp[kMaxTimestampLength];
+    size_t timestamp_length = FormatTimestamp(event.timestamp, timestamp_precision_, timestamp);
+
+    out.Append(std::string_view("{\"ts\":\""));
+    out.Append(timestamp, timestamp_length);
+    out.Append(std::string_view("\",\"level\":\""));
+    out.Append(std::string_view(LogLevelToString(event.level)));
+    out.Append('"');
+    if (!event.module.empty()) {
+        out.Append(std::string_view(",\"module\":"));
+        AppendJsonString(event.module, out);
+    }
+    out.Append(std::string_view(",\"file\":"));
+    AppendJsonString(NonNull(event.Filename()), out);
+    out.Append(std::string_view(",\"func\":"));
+    AppendJsonString(NonNull(event.Function()), out);
+    out.Append(std::string_view(",\"line\":"));
+    AppendLine(event.Line(), out);
+    out.Append(std::string_view(",\"msg\":"));
+
+    // 直接给出的日志内容就地转义，格式化的日志内容先展开到线程私有的缓冲区再转义
+    if (event.Format() == nullptr) {
+        AppendJsonString(event.message, out);
+    } else {
+        thread_local FormatBuffer message;
+        message.clear();
+        AppendMessage(event, message);
+        AppendJsonString(message.view(), out);
+    }
+
+    if (!event.args.empty()) {
+        AppendJsonFields(event.args, out);
+    }
+    out.Append(std::string_view("}\n"));
+}
+
+}  // namespace tinylog::internal
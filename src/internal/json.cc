@@ -0,0 +1,102 @@
+#include "tinylog/internal/json.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <array>
+#include <cstdint>
+
+namespace tinylog::internal {
+
+namespace {
+
+// 各字节是否需要转义
+constexpr std::array<bool, 256> MakeEscapeTable() {
+    std::array<bool, 256> table{};
+    for (size_t c = 0; c < 0x20; ++c) {
+        table[c] = true;
+    }
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+}
+
+constexpr std::array<bool, 256> kEscapeTable = MakeEscapeTable();
+
+void AppendEscape(char c, FormatBuffer& out) {
+    switch (c) {
+        case '"':
+            out.Append(std::string_view("\\\""));
+            return;
+        case '\\':
+            out.Append(std::string_view("\\\\"));
+            return;
+        case '\n':
+            out.Append(std::string_view("\\n"));
+            return;
+        case '\r':
+            out.Append(std::string_view("\\r"));
+            return;
+        case '\t':
+            out.Append(std::string_view("\\t"));
+            return;
+        case '\b':
+            out.Append(std::string_view("\\b"));
+            return;
+        case '\f':
+            out.Append(std::string_view("\\f"));
+            return;
+        default: {
+            static constexpr char kHex[] = "0123456789abcdef";
+            auto byte = static_cast<uint8_t>(c);
+            char escaped[6] = {'\\', 'u', '0', '0', kHex[byte >> 4], kHex[byte & 0xF]};
+            out.Append(escaped, sizeof(escaped));
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+size_t FindJsonEscape(std::string_view str, size_t start) noexcept {
+    const char* data = str.data();
+    size_t size = str.size();
+    size_t i = start;
+
+#if defined(__SSE2__)
+    // 字节不大于0x1F等价于max(byte, 0x1F) == 0x1F（无符号比较）
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int mask = _mm_movemask_epi8(matches);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if (kEscapeTable[static_cast<uint8_t>(data[i])]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+void AppendJsonEscaped(std::string_view str, FormatBuffer& out) {
+    // 不需要转义的连续字节整段复制
+    size_t copied = 0;
+    for (size_t pos = FindJsonEscape(str, 0); pos < str.size(); pos = FindJsonEscape(str, pos + 1)) {
+        out.Append(str.data() + copied, pos - copied);
+        AppendEscape(str[pos], out);
+        copied = pos + 1;
+    }
+    out.Append(str.data() + copied, str.size() - copied);
+}
+
+}  // namespace tinylog::internal
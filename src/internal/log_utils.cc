@@ -1,22 +1,163 @@
 #include "tinylog/internal/log_utils.h"
 
 #include <sys/stat.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
 #include <ctime>
-#include <fstream>
 #include <string>
 
 namespace tinylog::internal {
 
-std::string GetCurrentTimestamp() {
-    time_t now = time(nullptr);
-    struct tm local_time;
-    localtime_r(&now, &local_time);
+namespace {
 
-    char buffer[32];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
-    return std::string(buffer);
+constexpr int64_t kNanosPerSecond = 1000000000;
+
+int64_t ReadClock(clockid_t clock_id) {
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * kNanosPerSecond + ts.tv_nsec;
+}
+
+// 粗粒度单调时钟，读取开销低于实时时钟，启动时记录与实时时钟的偏移
+class CoarseClock {
+public:
+    CoarseClock() : offset_(ReadClock(CLOCK_REALTIME) - ReadMonotonic()) {}
+
+    int64_t Now() const { return ReadMonotonic() + offset_; }
+
+private:
+    static int64_t ReadMonotonic() {
+#ifdef CLOCK_MONOTONIC_COARSE
+        return ReadClock(CLOCK_MONOTONIC_COARSE);
+#else
+        return ReadClock(CLOCK_MONOTONIC);
+#endif
+    }
+
+    int64_t offset_;
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+// CPU时间戳计数器时钟，启动时忙等一小段时间校准计数频率并与实时时钟对齐
+class TscClock {
+public:
+    TscClock() {
+        int64_t start_ns = ReadClock(CLOCK_REALTIME);
+        uint64_t start_tsc = __rdtsc();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+        }
+        int64_t end_ns = ReadClock(CLOCK_REALTIME);
+        uint64_t end_tsc = __rdtsc();
+
+        base_ns_ = end_ns;
+        base_tsc_ = end_tsc;
+        ns_per_tick_ = end_tsc > start_tsc ? static_cast<double>(end_ns - start_ns) / (end_tsc - start_tsc) : 0.0;
+    }
+
+    int64_t Now() const {
+        if (ns_per_tick_ <= 0.0) {
+            return ReadClock(CLOCK_REALTIME);
+        }
+        return base_ns_ + static_cast<int64_t>(static_cast<double>(__rdtsc() - base_tsc_) * ns_per_tick_);
+    }
+
+private:
+    int64_t base_ns_ = 0;
+    uint64_t base_tsc_ = 0;
+    double ns_per_tick_ = 0.0;
+};
+#endif
+
+const CoarseClock& GetCoarseClock() {
+    static const CoarseClock clock;
+    return clock;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+const TscClock& GetTscClock() {
+    static const TscClock clock;
+    return clock;
+}
+#endif
+
+}  // namespace
+
+int64_t GetCurrentTimeNanos() { return ReadClock(CLOCK_REALTIME); }
+
+int64_t GetCurrentTimeNanos(ClockSource source) {
+    switch (source) {
+        case ClockSource::kCoarse:
+            return GetCoarseClock().Now();
+        case ClockSource::kTsc:
+#if defined(__x86_64__) || defined(__i386__)
+            return GetTscClock().Now();
+#else
+            return GetCoarseClock().Now();  // 不支持TSC的平台退化为粗粒度时钟
+#endif
+        case ClockSource::kRealtime:
+        default:
+            return ReadClock(CLOCK_REALTIME);
+    }
+}
+
+void InitClockSource(ClockSource source) { GetCurrentTimeNanos(source); }
+
+size_t FormatTimestamp(int64_t timestamp_ns, TimestampPrecision precision, char* buffer) {
+    // 线程私有的日期时间前缀缓存
+    struct PrefixCache {
+        int64_t second = INT64_MIN;
+        char prefix[kMaxTimestampLength];
+        size_t length = 0;
+    };
+    thread_local PrefixCache cache;
+
+    int64_t second = timestamp_ns / kNanosPerSecond;
+    int64_t sub_second = timestamp_ns % kNanosPerSecond;
+    if (sub_second < 0) {
+        sub_second += kNanosPerSecond;
+        --second;
+    }
+
+    if (second != cache.second) {
+        time_t time_value = static_cast<time_t>(second);
+        struct tm local_time;
+        localtime_r(&time_value, &local_time);
+        cache.length = strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%d %H:%M:%S", &local_time);
+        cache.second = second;
+    }
+
+    memcpy(buffer, cache.prefix, cache.length);
+    size_t length = cache.length;
+
+    // 只填充亚秒部分
+    int digits = 0;
+    int64_t fraction = 0;
+    if (precision == TimestampPrecision::kMilliseconds) {
+        digits = 3;
+        fraction = sub_second / 1000000;
+    } else if (precision == TimestampPrecision::kMicroseconds) {
+        digits = 6;
+        fraction = sub_second / 1000;
+    }
+    if (digits > 0) {
+        buffer[length] = '.';
+        for (int i = digits; i > 0; --i) {
+            buffer[length + i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        length += digits + 1;
+    }
+
+    buffer[length] = '\0';
+    return length;
 }
 
 const char* LogLevelToString(LogLevel level) {
@@ -83,6 +224,162 @@ LogSink StringToLogSink(const std::string& sink_str) {
     }
 }
 
+std::string OverflowPolicyToString(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::kBlock:
+            return "block";
+        case OverflowPolicy::kDropNewest:
+            return "drop_newest";
+        case OverflowPolicy::kDropOldest:
+            return "drop_oldest";
+        default:
+            return "unknown";
+    }
+}
+
+OverflowPolicy StringToOverflowPolicy(const std::string& policy_str) {
+    std::string lower_str = policy_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "drop_newest") {
+        return OverflowPolicy::kDropNewest;
+    } else if (lower_str == "drop_oldest") {
+        return OverflowPolicy::kDropOldest;
+    } else {
+        return OverflowPolicy::kBlock;  // 默认阻塞等待
+    }
+}
+
+std::string TimestampPrecisionToString(TimestampPrecision precision) {
+    switch (precision) {
+        case TimestampPrecision::kSeconds:
+            return "s";
+        case TimestampPrecision::kMilliseconds:
+            return "ms";
+        case TimestampPrecision::kMicroseconds:
+            return "us";
+        default:
+            return "unknown";
+    }
+}
+
+TimestampPrecision StringToTimestampPrecision(const std::string& precision_str) {
+    std::string lower_str = precision_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "s") {
+        return TimestampPrecision::kSeconds;
+    } else if (lower_str == "us") {
+        return TimestampPrecision::kMicroseconds;
+    } else {
+        return TimestampPrecision::kMilliseconds;  // 默认毫秒精度
+    }
+}
+
+std::string ClockSourceToString(ClockSource source) {
+    switch (source) {
+        case ClockSource::kRealtime:
+            return "realtime";
+        case ClockSource::kCoarse:
+            return "coarse";
+        case ClockSource::kTsc:
+            return "tsc";
+        default:
+            return "unknown";
+    }
+}
+
+ClockSource StringToClockSource(const std::string& source_str) {
+    std::string lower_str = source_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "coarse") {
+        return ClockSource::kCoarse;
+    } else if (lower_str == "tsc") {
+        return ClockSource::kTsc;
+    } else {
+        return ClockSource::kRealtime;  // 默认使用实时时钟
+    }
+}
+
+std::string RotationModeToString(RotationMode mode) {
+    switch (mode) {
+        case RotationMode::kSize:
+            return "size";
+        case RotationMode::kDaily:
+            return "daily";
+        case RotationMode::kHourly:
+            return "hourly";
+        default:
+            return "unknown";
+    }
+}
+
+RotationMode StringToRotationMode(const std::string& mode_str) {
+    std::string lower_str = mode_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "daily") {
+        return RotationMode::kDaily;
+    } else if (lower_str == "hourly") {
+        return RotationMode::kHourly;
+    } else {
+        return RotationMode::kSize;  // 默认按文件大小滚动
+    }
+}
+
+std::string FileEngineToString(FileEngine engine) {
+    switch (engine) {
+        case FileEngine::kBuffered:
+            return "buffered";
+        case FileEngine::kMmap:
+            return "mmap";
+        case FileEngine::kIoUring:
+            return "io_uring";
+        default:
+            return "unknown";
+    }
+}
+
+FileEngine StringToFileEngine(const std::string& engine_str) {
+    std::string lower_str = engine_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "mmap") {
+        return FileEngine::kMmap;
+    } else if (lower_str == "io_uring") {
+        return FileEngine::kIoUring;
+    } else {
+        return FileEngine::kBuffered;  // 默认使用缓冲写入
+    }
+}
+
+std::string LogLayoutToString(LogLayout layout) {
+    switch (layout) {
+        case LogLayout::kText:
+            return "text";
+        case LogLayout::kJson:
+            return "json";
+        case LogLayout::kBinary:
+            return "binary";
+        default:
+            return "unknown";
+    }
+}
+
+LogLayout StringToLogLayout(const std::string& layout_str) {
+    std::string lower_str = layout_str;
+    std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ::tolower);
+
+    if (lower_str == "json") {
+        return LogLayout::kJson;
+    } else if (lower_str == "binary") {
+        return LogLayout::kBinary;
+    } else {
+        return LogLayout::kText;  // 默认使用文本格式
+    }
+}
+
 void Trim(std::string& str) {
     // 去除开头的空格和制表符
     size_t start = str.find_first_not_of(" \t");
@@ -97,19 +394,11 @@ void Trim(std::string& str) {
 }
 
 time_t GetFileLastModifiedTime(const std::string& file_path) {
-    std::ifstream file(file_path, std::ios::in);
-    if (!file) {
-        return 0;
-    }
-
-    time_t last_modified = 0;
     struct stat file_stat;
-    if (stat(file_path.c_str(), &file_stat) == 0) {
-        last_modified = file_stat.st_mtime;
+    if (stat(file_path.c_str(), &file_stat) != 0) {
+        return 0;
     }
-
-    file.close();
-    return last_modified;
+    return file_stat.st_mtime;
 }
 
 }  // namespace tinylog::internal
@@ -0,0 +1,147 @@
+#include "tinylog/internal/maintenance.h"
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace tinylog::internal {
+
+namespace {
+
+// 维护线程的nice值
+constexpr int kWorkerNiceValue = 10;
+
+// 没有定时任务时空闲等待的最长时间
+constexpr auto kIdleWaitTime = std::chrono::seconds(1);
+
+}  // namespace
+
+MaintenanceWorker& MaintenanceWorker::GetInstance() {
+    // 有意不释放：日志管理器等静态对象析构时仍可能投递任务并等待其完成
+    static MaintenanceWorker* instance = new MaintenanceWorker();
+    return *instance;
+}
+
+MaintenanceWorker::MaintenanceWorker() { std::thread(&MaintenanceWorker::Run, this).detach(); }
+
+void MaintenanceWorker::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_cv_.notify_one();
+}
+
+uint64_t MaintenanceWorker::AddTimer(std::chrono::milliseconds interval, std::function<void()> task) {
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_timer_id_++;
+        timers_.push_back(Timer{id, interval, std::chrono::steady_clock::now() + interval, std::move(task)});
+    }
+    task_cv_.notify_one();
+    return id;
+}
+
+void MaintenanceWorker::RemoveTimer(uint64_t id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    timers_.erase(std::remove_if(timers_.begin(), timers_.end(), [id](const Timer& timer) { return timer.id == id; }),
+                  timers_.end());
+    timer_cv_.wait(lock, [this, id] { return running_timer_ != id; });
+}
+
+void MaintenanceWorker::Run() {
+#ifdef __linux__
+    // 降低本线程的调度优先级，压缩等耗时任务不与业务线程争抢CPU（Linux下nice值按线程生效）
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), kWorkerNiceValue);
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto next_due = RunDueTimers(lock);
+        if (tasks_.empty()) {
+            task_cv_.wait_until(lock, next_due);
+            continue;
+        }
+
+        std::function<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            fprintf(stderr, "Log maintenance task failed: %s\n", e.what());
+        }
+
+        lock.lock();
+    }
+}
+
+std::chrono::steady_clock::time_point MaintenanceWorker::RunDueTimers(std::unique_lock<std::mutex>& lock) {
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        auto due = std::find_if(timers_.begin(), timers_.end(), [now](const Timer& timer) { return timer.due <= now; });
+        if (due == timers_.end()) {
+            break;
+        }
+
+        // 执行期间可能有定时任务登记或注销，先复制任务再释放锁
+        std::function<void()> task = due->task;
+        due->due = now + due->interval;
+        running_timer_ = due->id;
+        lock.unlock();
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            fprintf(stderr, "Log timer task failed: %s\n", e.what());
+        }
+
+        lock.lock();
+        running_timer_ = 0;
+        timer_cv_.notify_all();
+    }
+
+    auto next_due = std::chrono::steady_clock::now() + kIdleWaitTime;
+    for (const auto& timer : timers_) {
+        next_due = std::min(next_due, timer.due);
+    }
+    return next_due;
+}
+
+void MaintenanceTasks::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    MaintenanceWorker::GetInstance().Post([this, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            Finish();
+            throw;
+        }
+        Finish();
+    });
+}
+
+void MaintenanceTasks::Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void MaintenanceTasks::Finish() {
+    // 在锁内通知：等待方重新获取锁之后才能返回并销毁本对象
+    std::lock_guard<std::mutex> lock(mutex_);
+    --pending_;
+    done_cv_.notify_all();
+}
+
+}  // namespace tinylog::internal
@@ -1,123 +1,643 @@
 #include "tinylog/internal/sink_interface.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
-#include <filesystem>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "tinylog/internal/crash_handler.h"
 #include "tinylog/internal/log_utils.h"
+#include "tinylog/internal/maintenance.h"
 
 namespace tinylog::internal {
 
+namespace {
+
+// 线程私有的格式化缓冲区，按格式化器区分，容量在多次日志之间复用
+struct FormatCacheEntry {
+    const Formatter* formatter = nullptr;
+    FormatBuffer buffer;
+};
+
+std::vector<FormatCacheEntry>& GetFormatCache() {
+    thread_local std::vector<FormatCacheEntry> cache;
+    return cache;
+}
+
+// 滚动时临时文件名的序号，保证同一路径的多次滚动互不冲突
+std::atomic<uint64_t> g_rotation_seq{0};
+
+// 内存映射失败后重新尝试映射的最小间隔
+constexpr int64_t kRemapRetryNs = 1000000000;
+
+}  // namespace
+
 void SinkInterface::log(const LogEvent& event) {
-    std::string formatted_message = format(event);
-    write(formatted_message);
+    std::vector<FormatCacheEntry>& cache = GetFormatCache();
+    if (cache.empty()) {
+        cache.emplace_back();
+    }
+    if (!formatter_) {
+        writeEvent(event);
+        return;
+    }
+    FormatBuffer& buffer = cache.front().buffer;
+    formatter_->format(event, buffer);
+    write(buffer.view(), event.level);
 }
 
-std::string SinkInterface::format(const LogEvent& event) {
-    std::string timestamp = GetCurrentTimestamp();
-    const char* level_str = LogLevelToString(event.level);
+void SinkInterface::dispatch(const LogEvent& event, const std::vector<std::shared_ptr<SinkInterface>>& sinks) {
+    std::vector<FormatCacheEntry>& cache = GetFormatCache();
+    size_t used = 0;
+    for (const auto& sink : sinks) {
+        const Formatter* formatter = sink->formatter();
+        if (formatter == nullptr) {
+            sink->writeEvent(event);
+            continue;
+        }
+
+        // 查找本条日志是否已经用同一个格式化器格式化过
+        size_t index = 0;
+        while (index < used && cache[index].formatter != formatter) {
+            ++index;
+        }
+        if (index == used) {
+            if (cache.size() <= used) {
+                cache.emplace_back();
+            }
+            cache[used].formatter = formatter;
+            formatter->format(event, cache[used].buffer);
+            ++used;
+        }
+
+        sink->write(cache[index].buffer.view(), event.level);
+    }
+}
+
+void SinkInterface::collectStats(SinkStats& stats) const {
+    stats.bytes_written = counters_.Sum(kBytesWritten);
+    stats.write_calls = counters_.Sum(kWriteCalls);
+    stats.rotations = counters_.Sum(kRotations);
+    stats.dropped = counters_.Sum(kDropped);
+    stats.flushes = 0;
+    for (size_t i = 0; i < kFlushLatencyBuckets; ++i) {
+        stats.flush_latency_us[i] = flush_latency_[i].load(std::memory_order_relaxed);
+        stats.flushes += stats.flush_latency_us[i];
+    }
+}
 
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), "[%s] [%s] %s:%s:%d - %s\n", timestamp.c_str(), level_str, event.filename,
-             event.function, event.line, event.message.c_str());
+void SinkInterface::recordFlush(int64_t start_ns) noexcept {
+    uint64_t elapsed_us = static_cast<uint64_t>(std::max<int64_t>(MonotonicNanos() - start_ns, 0)) / 1000;
+    size_t bucket = elapsed_us == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(elapsed_us));
+    flush_latency_[std::min(bucket, kFlushLatencyBuckets - 1)].fetch_add(1, std::memory_order_relaxed);
+}
 
-    return std::string(buffer);
+int64_t SinkInterface::MonotonicNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
 }
 
 // ConsoleSink implementation
-void ConsoleSink::write(const std::string& message) {
-    fputs(message.c_str(), stdout);
+void ConsoleSink::write(std::string_view message, LogLevel level) {
+    fwrite(message.data(), 1, message.size(), stdout);
+    recordWrite(message.size());
+    if (level >= flush_level_) {
+        flush();
+    }
+}
+
+void ConsoleSink::flush() {
+    int64_t start_ns = MonotonicNanos();
     fflush(stdout);
+    recordWriteCall();
+    recordFlush(start_ns);
 }
 
+int ConsoleSink::crashFlush() noexcept { return STDOUT_FILENO; }
+
 // FileSink implementation
-FileSink::FileSink(const std::string& file_path, int32_t max_file_count, size_t max_file_size)
-    : file_path_(file_path), max_file_count_(max_file_count), max_file_size_(max_file_size) {
+FileSink::FileSink(const std::string& file_path, int32_t max_file_count, size_t max_file_size,
+                   const FlushPolicy& flush_policy)
+    : FileSink(file_path, RotationPolicy{RotationMode::kSize, max_file_count, max_file_size, 0, false}, flush_policy) {}
+
+FileSink::FileSink(const std::string& file_path, const RotationPolicy& rotation_policy,
+                   const FlushPolicy& flush_policy, FileEngine engine)
+    : file_path_(file_path),
+      rotation_policy_(rotation_policy),
+      flush_policy_(flush_policy),
+      writer_(CreateFileWriter(engine, flush_policy.buffer_size)) {
+    if (rotation_policy_.compress && !IsCompressionSupported()) {
+        fprintf(stderr, "Log compression is not supported in this build, keeping rotated files uncompressed\n");
+        rotation_policy_.compress = false;
+    }
+    buffer_.reserve(flush_policy_.buffer_size);
+    last_flush_ns_ = GetCurrentTimeNanos(ClockSource::kCoarse);
+
     // 打开日志文件
-    log_file_.open(file_path_, std::ios::out | std::ios::app);
-    if (!log_file_.is_open()) {
-        fprintf(stderr, "Failed to open log file: %s\n", file_path_.c_str());
+    {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        if (!openFile()) {
+            fprintf(stderr, "Failed to open log file: %s\n", file_path_.c_str());
+        }
+    }
+    RegisterCrashSink(this);
+
+    // 每隔四分之一个刷新间隔检查一次，缓冲的日志最多在刷新间隔的1.25倍之后落盘
+    if (flush_policy_.interval_ms > 0 && flush_policy_.buffer_size > 0) {
+        auto period = std::chrono::milliseconds(std::max<int64_t>(flush_policy_.interval_ms / 4, 1));
+        flush_timer_ = MaintenanceWorker::GetInstance().AddTimer(period, [this] { flushOnTimer(); });
     }
 }
 
 FileSink::~FileSink() {
-    if (log_file_.is_open()) {
-        log_file_.close();
+    if (flush_timer_ != 0) {
+        MaintenanceWorker::GetInstance().RemoveTimer(flush_timer_);
+    }
+    UnregisterCrashSink(this);
+    {
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        closeFile();
     }
+
+    // 在锁外等待本sink的改名任务完成，保证sink销毁后备份文件已就位
+    maintenance_.Wait();
 }
 
-void FileSink::write(const std::string& message) {
+void FileSink::write(std::string_view message, LogLevel level) {
     std::lock_guard<std::mutex> lock(file_mutex_);
+    if (prepareFile()) {
+        append(message, level);
+    }
+}
 
-    if (!log_file_.is_open()) {
-        log_file_.open(file_path_, std::ios::out | std::ios::app);
-        if (!log_file_.is_open()) {
-            return;
-        }
+int FileSink::crashFlush() noexcept {
+    // 文件锁可能被崩溃的线程持有，等待超时后不加锁直接写出，最多重复或截断一条日志
+    bool locked = CrashTryLock(file_mutex_);
+    int fd = fd_;
+    if (fd >= 0) {
+        // 缓冲区的内容写入其在文件中的位置，之后的文本从文件末尾追加。
+        // io_uring已提交的写入由内核完成，进程退出前未完成的写入可能丢失
+        CrashWrite(fd, buffer_.data(), buffer_.size(), static_cast<off_t>(file_size_ - buffer_.size()));
+        buffer_.clear();
+        ::lseek(fd, static_cast<off_t>(file_size_), SEEK_SET);
+    }
+    if (locked) {
+        file_mutex_.unlock();
+    }
+    return fd;
+}
+
+bool FileSink::prepareFile() {
+    if (fd_ < 0 && !openFile()) {
+        return false;
     }
 
     // 检查是否需要滚动文件
     if (shouldRotateFile()) {
         rotateFile();
     }
+    return fd_ >= 0;
+}
+
+void FileSink::append(std::string_view message, LogLevel level) {
+    size_t capacity = flush_policy_.buffer_size;
+    if (buffer_.size() + message.size() > capacity) {
+        if (message.size() >= capacity) {
+            // 消息本身超过缓冲区大小，与缓冲区中的数据合并为一次写入
+            int64_t start_ns = MonotonicNanos();
+            writer_->write(fd_, buffer_, message, file_size_ - buffer_.size());
+            file_size_ += message.size();
+            last_flush_ns_ = GetCurrentTimeNanos(ClockSource::kCoarse);
+            recordWrite(message.size());
+            recordWriteCall();
+            recordFlush(start_ns);
+            return;
+        }
+        flushBuffer();
+    }
 
-    // 写入日志
-    log_file_ << message;
+    buffer_.insert(buffer_.end(), message.begin(), message.end());
+    file_size_ += message.size();
+    recordWrite(message.size());
 
-    // 检查写入是否成功
-    if (log_file_.fail()) {
-        fprintf(stderr, "Failed to write to log file: %s\n", file_path_.c_str());
-        log_file_.clear();
+    // 按刷新策略决定是否立即写入文件
+    bool should_flush = level >= flush_policy_.flush_level || buffer_.size() >= capacity;
+    if (!should_flush && flush_policy_.interval_ms > 0) {
+        int64_t now = GetCurrentTimeNanos(ClockSource::kCoarse);
+        should_flush = now - last_flush_ns_ >= flush_policy_.interval_ms * 1000000;
+    }
+    if (should_flush) {
+        flushBuffer();
     }
 }
 
 void FileSink::flush() {
     std::lock_guard<std::mutex> lock(file_mutex_);
-    if (log_file_.is_open()) {
-        log_file_.flush();
+    flushBuffer();
+    writer_->wait();
+}
+
+void FileSink::flushOnTimer() {
+    // 锁被写入线程持有时由其在写入后自行按间隔检查，定时任务不等待
+    std::unique_lock<std::mutex> lock(file_mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || buffer_.empty()) {
+        return;
+    }
+    int64_t now = GetCurrentTimeNanos(ClockSource::kCoarse);
+    if (now - last_flush_ns_ >= flush_policy_.interval_ms * 1000000) {
+        flushBuffer();
+    }
+}
+
+bool FileSink::openFile() {
+    fd_ = ::open(file_path_.c_str(), writer_->openFlags(), 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    bool has_stat = fstat(fd_, &file_stat) == 0;
+    file_size_ = has_stat ? static_cast<size_t>(file_stat.st_size) : 0;
+    ++file_generation_;
+
+    // 已有内容的文件按最后修改时间确定所属时间段，重启后跨越时间段的旧文件会在首次写入时滚动
+    if (rotation_policy_.mode != RotationMode::kSize) {
+        int64_t timestamp = GetCurrentTimeNanos(ClockSource::kCoarse);
+        if (has_stat && file_size_ > 0) {
+            timestamp = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+        }
+        period_ = GetRotationPeriod(rotation_policy_.mode, timestamp);
+    }
+    return true;
+}
+
+void FileSink::closeFile() {
+    flushBuffer();
+    writer_->wait();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void FileSink::flushBuffer() {
+    if (buffer_.empty() || fd_ < 0) {
+        return;
     }
+
+    int64_t start_ns = MonotonicNanos();
+    writer_->write(fd_, buffer_, std::string_view(), file_size_ - buffer_.size());
+    last_flush_ns_ = GetCurrentTimeNanos(ClockSource::kCoarse);
+    recordWriteCall();
+    recordFlush(start_ns);
 }
 
 void FileSink::rotateFile() {
+    // 旧文件描述符交给维护线程关闭前，先等待其上的写入全部完成
+    flushBuffer();
+    writer_->wait();
+
+    // 当前文件先改为唯一的临时名称，随即打开新文件继续写入；
+    // 旧文件的关闭和备份文件的逐级改名交给维护线程，写入路径不等待这些目录操作
+    std::string pending_file = file_path_ + ".rotating." + std::to_string(g_rotation_seq.fetch_add(1));
+    if (::rename(file_path_.c_str(), pending_file.c_str()) != 0) {
+        fprintf(stderr, "Failed to rotate log file: %s\n", file_path_.c_str());
+        pending_file.clear();
+    }
+
+    int old_fd = fd_;
+    std::string period_label = period_.label;
+    fd_ = -1;
+    if (!openFile()) {
+        fprintf(stderr, "Failed to create new log file: %s\n", file_path_.c_str());
+    }
+
+    recordRotation();
+    maintenance_.Post([old_fd, pending_file = std::move(pending_file), file_path = file_path_,
+                                           period_label = std::move(period_label), policy = rotation_policy_] {
+        ::close(old_fd);
+        if (!pending_file.empty()) {
+            ArchiveRotatedFile(file_path, pending_file, period_label, policy);
+        }
+    });
+}
+
+bool FileSink::shouldRotateFile() {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (file_size_ >= rotation_policy_.max_file_size) {
+        return true;
+    }
+    if (rotation_policy_.mode == RotationMode::kSize) {
+        return false;
+    }
+
+    // 按时间滚动时检查是否进入了新的时间段，空文件无需滚动，只更新所属时间段
+    int64_t now = GetCurrentTimeNanos(ClockSource::kCoarse);
+    if (now < period_.end_ns) {
+        return false;
+    }
+    if (file_size_ == 0) {
+        period_ = GetRotationPeriod(rotation_policy_.mode, now);
+        return false;
+    }
+    return true;
+}
+
+// BinaryFileSink implementation
+BinaryFileSink::BinaryFileSink(const std::string& file_path, const RotationPolicy& rotation_policy,
+                               const FlushPolicy& flush_policy, FileEngine engine)
+    : FileSink(file_path, rotation_policy, flush_policy, engine) {
+    setFormatter(nullptr);
+}
+
+BinaryFileSink::~BinaryFileSink() = default;
+
+int BinaryFileSink::crashFlush() noexcept {
+    FileSink::crashFlush();
+    return -1;
+}
+
+void BinaryFileSink::writeEvent(const LogEvent& event) {
     std::lock_guard<std::mutex> lock(file_mutex_);
+    if (!prepareFile()) {
+        return;
+    }
+
+    // 编码结果写入线程私有的缓冲区，容量在多次日志之间复用
+    thread_local FormatBuffer buffer;
+    buffer.clear();
+
+    // 打开了新文件（首次写入、滚动或重新打开）时开始新的会话，空文件先写文件头
+    if (encoded_generation_ != fileGeneration()) {
+        encoded_generation_ = fileGeneration();
+        encoder_.BeginSession(fileSize() == 0, buffer);
+    }
+    encoder_.Encode(event, buffer);
+    append(buffer.view(), event.level);
+}
 
-    // 关闭当前日志文件
-    if (log_file_.is_open()) {
-        log_file_.close();
+// MmapFileSink implementation
+MmapFileSink::MmapFileSink(const std::string& file_path, const RotationPolicy& rotation_policy)
+    : file_path_(file_path), rotation_policy_(rotation_policy) {
+    if (rotation_policy_.compress && !IsCompressionSupported()) {
+        fprintf(stderr, "Log compression is not supported in this build, keeping rotated files uncompressed\n");
+        rotation_policy_.compress = false;
     }
 
-    // 生成备份文件名并移动
-    for (int i = max_file_count_ - 1; i > 0; --i) {
-        std::string old_file = file_path_ + "." + std::to_string(i);
-        std::string new_file = file_path_ + "." + std::to_string(i + 1);
+    std::lock_guard<std::mutex> lock(rotate_mutex_);
+    if (mapSegment(segments_[0], 0)) {
+        current_.store(&segments_[0], std::memory_order_seq_cst);
+        next_slot_ = 1;
+    } else {
+        fprintf(stderr, "Failed to map log file, dropping records until it can be mapped: %s\n", file_path_.c_str());
+        next_remap_ns_.store(MonotonicNanos() + kRemapRetryNs, std::memory_order_relaxed);
+    }
+}
 
-        if (std::filesystem::exists(old_file)) {
-            std::filesystem::rename(old_file, new_file);
+MmapFileSink::~MmapFileSink() {
+    {
+        std::lock_guard<std::mutex> lock(rotate_mutex_);
+        MmapSegment* segment = current_.exchange(nullptr, std::memory_order_seq_cst);
+        if (segment != nullptr) {
+            unmapSegment(*segment);
         }
     }
 
-    // 重命名当前日志文件为 .1
-    std::string backup_file = file_path_ + ".1";
-    if (std::filesystem::exists(file_path_)) {
-        std::filesystem::rename(file_path_, backup_file);
+    // 在锁外等待本sink的回收任务，回收任务引用了本对象中的分段
+    maintenance_.Wait();
+}
+
+void MmapFileSink::write(std::string_view message, LogLevel level) {
+    for (;;) {
+        MmapSegment* segment = current_.load(std::memory_order_seq_cst);
+        if (segment == nullptr) {
+            if (remapSegment(message.size())) {
+                continue;
+            }
+            unmapped_drops_.fetch_add(1, std::memory_order_relaxed);
+            recordDrop();
+            return;
+        }
+
+        // 先登记写入线程再确认分段仍是当前分段，回收线程看到写入计数归零后即可安全解除映射
+        segment->writers.fetch_add(1, std::memory_order_seq_cst);
+        if (segment != current_.load(std::memory_order_seq_cst)) {
+            segment->writers.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+
+        bool in_period = rotation_policy_.mode == RotationMode::kSize ||
+                         GetCurrentTimeNanos(ClockSource::kCoarse) < segment->period_end_ns.load(std::memory_order_relaxed);
+        if (in_period) {
+            size_t offset = segment->reserved.fetch_add(message.size(), std::memory_order_relaxed);
+            if (offset + message.size() <= segment->capacity) {
+                memcpy(segment->data + offset, message.data(), message.size());
+                segment->committed.fetch_add(message.size(), std::memory_order_release);
+                segment->writers.fetch_sub(1, std::memory_order_release);
+                recordWrite(message.size());
+                return;
+            }
+        }
+
+        // 分段已写满或进入了新的时间段，切换分段后重试
+        segment->writers.fetch_sub(1, std::memory_order_release);
+        rotateSegment(segment, message.size());
     }
+}
 
-    // 重新打开新的日志文件
-    log_file_.open(file_path_, std::ios::out | std::ios::trunc);
-    if (!log_file_.is_open()) {
-        fprintf(stderr, "Failed to create new log file: %s\n", file_path_.c_str());
+void MmapFileSink::flush() {
+    std::lock_guard<std::mutex> lock(rotate_mutex_);
+    MmapSegment* segment = current_.load(std::memory_order_seq_cst);
+    if (segment != nullptr) {
+        int64_t start_ns = MonotonicNanos();
+        size_t length = segment->start + segment->committed.load(std::memory_order_acquire);
+        msync(segment->data, std::min(length, segment->capacity), MS_ASYNC);
+        recordFlush(start_ns);
     }
 }
 
-bool FileSink::shouldRotateFile() const {
-    if (!log_file_.is_open()) {
+bool MmapFileSink::mapSegment(MmapSegment& segment, size_t min_capacity) {
+    int fd = ::open(file_path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t existing = static_cast<size_t>(file_stat.st_size);
+
+    // 映射长度按页对齐，至少能容纳已有内容和待写入的日志
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t capacity = std::max(rotation_policy_.max_file_size, existing + min_capacity);
+    capacity = std::max((capacity + page_size - 1) / page_size * page_size, page_size);
+
+    // 预分配磁盘空间，文件系统不支持时退化为扩展文件长度
+    if (::fallocate(fd, 0, 0, static_cast<off_t>(capacity)) != 0 &&
+        ::ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
         return false;
     }
 
-    log_file_.seekp(0, std::ios::end);
-    std::streampos pos = log_file_.tellp();
-    return static_cast<size_t>(pos) >= max_file_size_;
+    // 上次运行未正常截断时文件末尾是预分配的空字节，从最后一个非空字节之后继续写入
+    char* bytes = static_cast<char*>(data);
+    while (existing > 0 && bytes[existing - 1] == '\0') {
+        --existing;
+    }
+
+    segment.fd = fd;
+    segment.data = bytes;
+    segment.capacity = capacity;
+    segment.start = existing;
+    segment.reserved.store(existing, std::memory_order_relaxed);
+    segment.committed.store(0, std::memory_order_relaxed);
+
+    if (rotation_policy_.mode != RotationMode::kSize) {
+        int64_t timestamp = GetCurrentTimeNanos(ClockSource::kCoarse);
+        if (existing > 0) {
+            timestamp = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+        }
+        RotationPeriod period = GetRotationPeriod(rotation_policy_.mode, timestamp);
+        segment.period_label = std::move(period.label);
+        segment.period_end_ns.store(period.end_ns, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void MmapFileSink::rotateSegment(MmapSegment* full, size_t required) {
+    std::unique_lock<std::mutex> lock(rotate_mutex_);
+    if (current_.load(std::memory_order_seq_cst) != full) {
+        return;  // 其他线程已经完成了切换
+    }
+
+    // 进入新的时间段但分段中还没有内容时，只需更新所属时间段
+    int64_t now = GetCurrentTimeNanos(ClockSource::kCoarse);
+    bool period_over =
+        rotation_policy_.mode != RotationMode::kSize && now >= full->period_end_ns.load(std::memory_order_relaxed);
+    if (period_over && full->start == 0 && full->committed.load(std::memory_order_acquire) == 0 &&
+        full->reserved.load(std::memory_order_relaxed) == 0) {
+        RotationPeriod period = GetRotationPeriod(rotation_policy_.mode, now);
+        full->period_label = std::move(period.label);
+        full->period_end_ns.store(period.end_ns, std::memory_order_relaxed);
+        return;
+    }
+
+    // 目标分段尚未解除映射时，释放锁后直接回收该分段，由调用方重试切换
+    MmapSegment& next = segments_[next_slot_];
+    if (next.retiring.load(std::memory_order_acquire)) {
+        lock.unlock();
+        releaseSegment(next);
+        return;
+    }
+
+    std::string pending_file = file_path_ + ".rotating." + std::to_string(g_rotation_seq.fetch_add(1));
+    if (::rename(file_path_.c_str(), pending_file.c_str()) != 0) {
+        fprintf(stderr, "Failed to rotate log file: %s\n", file_path_.c_str());
+        pending_file.clear();
+    }
+
+    // 切换到新的分段，映射失败时丢弃后续日志而不是阻塞写入线程，之后的写入定期重新尝试映射
+    MmapSegment* replacement = nullptr;
+    if (mapSegment(next, required)) {
+        replacement = &next;
+        next_slot_ = (next_slot_ + 1) % kSegmentSlots;
+    } else {
+        fprintf(stderr, "Failed to map new log file, dropping records until it can be mapped: %s\n",
+                file_path_.c_str());
+        next_remap_ns_.store(MonotonicNanos() + kRemapRetryNs, std::memory_order_relaxed);
+    }
+    full->unmap_claimed.store(false, std::memory_order_relaxed);
+    full->retiring.store(true, std::memory_order_release);
+    current_.store(replacement, std::memory_order_seq_cst);
+
+    recordRotation();
+    // 归档在分段截断之后进行，压缩期间分段已可复用
+    maintenance_.Post([full, pending_file = std::move(pending_file), file_path = file_path_,
+                       period_label = full->period_label, policy = rotation_policy_] {
+        releaseSegment(*full);
+        if (!pending_file.empty()) {
+            ArchiveRotatedFile(file_path, pending_file, period_label, policy);
+        }
+    });
+}
+
+bool MmapFileSink::remapSegment(size_t required) {
+    // 重试间隔内不获取锁，映射失败期间的写入只是一次原子读取
+    if (MonotonicNanos() < next_remap_ns_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(rotate_mutex_);
+    if (current_.load(std::memory_order_seq_cst) != nullptr) {
+        return true;  // 其他线程已经重新映射
+    }
+    if (MonotonicNanos() < next_remap_ns_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // 目标分段尚未解除映射时，释放锁后直接回收该分段，由调用方重试
+    MmapSegment& next = segments_[next_slot_];
+    if (next.retiring.load(std::memory_order_acquire)) {
+        lock.unlock();
+        releaseSegment(next);
+        return true;
+    }
+
+    if (!mapSegment(next, required)) {
+        next_remap_ns_.store(MonotonicNanos() + kRemapRetryNs, std::memory_order_relaxed);
+        return false;
+    }
+    next_slot_ = (next_slot_ + 1) % kSegmentSlots;
+    current_.store(&next, std::memory_order_seq_cst);
+    fprintf(stderr, "Mapped log file again after dropping %llu records: %s\n",
+            static_cast<unsigned long long>(unmapped_drops_.exchange(0, std::memory_order_relaxed)),
+            file_path_.c_str());
+    return true;
+}
+
+void MmapFileSink::releaseSegment(MmapSegment& segment) {
+    if (!segment.unmap_claimed.exchange(true, std::memory_order_acq_rel)) {
+        unmapSegment(segment);
+        segment.retiring.store(false, std::memory_order_release);
+        return;
+    }
+    while (segment.retiring.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void MmapFileSink::unmapSegment(MmapSegment& segment) {
+    while (segment.writers.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+
+    size_t length = segment.start + segment.committed.load(std::memory_order_acquire);
+    munmap(segment.data, segment.capacity);
+    if (::ftruncate(segment.fd, static_cast<off_t>(length)) != 0) {
+        fprintf(stderr, "Failed to truncate log file\n");
+    }
+    ::close(segment.fd);
+    segment.fd = -1;
+    segment.data = nullptr;
+    segment.capacity = 0;
 }
 
 }  // namespace tinylog::internal
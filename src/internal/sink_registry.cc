@@ -0,0 +1,231 @@
+#include "tinylog/internal/sink_registry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#include "tinylog/internal/log_utils.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+constexpr const char* kConsoleDestination = "console";
+
+// 文件的输出目标标识：规范化后的绝对路径，不同写法的同一路径对应同一个sink
+std::string FileDestination(const std::string& file_path) {
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::weakly_canonical(file_path, ec);
+    if (ec) {
+        path = std::filesystem::absolute(file_path, ec).lexically_normal();
+    }
+    return "file:" + (ec ? file_path : path.string());
+}
+
+// 文件sink的创建参数
+std::string FileSettings(const LogConfig& config) {
+    std::string settings;
+    settings.append(FileEngineToString(config.GetFileEngine()));
+    settings.append(1, '|').append(RotationModeToString(config.GetRotationMode()));
+    settings.append(1, '|').append(std::to_string(config.GetMaxFileCount()));
+    settings.append(1, '|').append(std::to_string(config.GetMaxFileSize()));
+    settings.append(1, '|').append(std::to_string(config.GetMaxTotalSize()));
+    settings.append(1, '|').append(config.IsCompress() ? "1" : "0");
+    settings.append(1, '|').append(std::to_string(config.GetFileBufferSize()));
+    settings.append(1, '|').append(std::to_string(config.GetFlushIntervalMs()));
+    settings.append(1, '|').append(LogLevelToString(config.GetFlushLevel()));
+    settings.append(1, '|').append(TimestampPrecisionToString(config.GetTimestampPrecision()));
+    settings.append(1, '|').append(LogLayoutToString(config.GetLogLayout()));
+    return settings;
+}
+
+// 控制台sink的创建参数
+std::string ConsoleSettings(const LogConfig& config) {
+    // 控制台不输出二进制格式，二进制格式与文本格式的控制台sink可以共享
+    LogLayout layout = config.GetLogLayout() == LogLayout::kBinary ? LogLayout::kText : config.GetLogLayout();
+    std::string settings(LogLevelToString(config.GetFlushLevel()));
+    settings.append(1, '|').append(TimestampPrecisionToString(config.GetTimestampPrecision()));
+    settings.append(1, '|').append(LogLayoutToString(layout));
+    return settings;
+}
+
+// 配置需要的输出目标及其创建参数
+struct SinkSpec {
+    std::string destination;
+    std::string settings;
+    bool is_file;
+};
+
+std::vector<SinkSpec> DescribeSinks(const LogConfig& config) {
+    std::vector<SinkSpec> specs;
+    if (config.GetLogSink() == LogSink::kConsole || config.GetLogSink() == LogSink::kBoth) {
+        specs.push_back(SinkSpec{kConsoleDestination, ConsoleSettings(config), false});
+    }
+    if (config.GetLogSink() == LogSink::kFile || config.GetLogSink() == LogSink::kBoth) {
+        specs.push_back(SinkSpec{FileDestination(config.GetFilePath()), FileSettings(config), true});
+    }
+    return specs;
+}
+
+// 按配置的写入方式创建文件sink
+std::shared_ptr<SinkInterface> CreateFileSink(const LogConfig& config) {
+    FlushPolicy flush_policy;
+    flush_policy.buffer_size = config.GetFileBufferSize();
+    flush_policy.interval_ms = config.GetFlushIntervalMs();
+    flush_policy.flush_level = config.GetFlushLevel();
+
+    RotationPolicy rotation_policy;
+    rotation_policy.mode = config.GetRotationMode();
+    rotation_policy.max_file_count = config.GetMaxFileCount();
+    rotation_policy.max_file_size = config.GetMaxFileSize();
+    rotation_policy.max_total_size = config.GetMaxTotalSize();
+    rotation_policy.compress = config.IsCompress();
+
+    if (config.GetLogLayout() == LogLayout::kBinary) {
+        FileEngine engine = config.GetFileEngine();
+        if (engine == FileEngine::kMmap) {
+            fprintf(stderr, "The binary log layout does not support the mmap file engine, using buffered writes\n");
+            engine = FileEngine::kBuffered;
+        }
+        return std::make_shared<BinaryFileSink>(config.GetFilePath(), rotation_policy, flush_policy, engine);
+    }
+    if (config.GetFileEngine() == FileEngine::kMmap) {
+        return std::make_shared<MmapFileSink>(config.GetFilePath(), rotation_policy);
+    }
+    return std::make_shared<FileSink>(config.GetFilePath(), rotation_policy, flush_policy, config.GetFileEngine());
+}
+
+}  // namespace
+
+SinkRegistry& SinkRegistry::GetInstance() {
+    // 有意不释放：日志管理器等静态对象析构时仍可能重新创建sink
+    static SinkRegistry* instance = new SinkRegistry();
+    return *instance;
+}
+
+std::vector<std::shared_ptr<SinkInterface>> SinkRegistry::AcquireSinks(const LogConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RemoveExpired();
+
+    std::shared_ptr<const Formatter> formatter = GetFormatter(config.GetLogLayout(), config.GetTimestampPrecision());
+    auto create_console = [&config, &formatter]() -> std::shared_ptr<SinkInterface> {
+        auto sink = std::make_shared<ConsoleSink>(config.GetFlushLevel());
+        sink->setFormatter(formatter);
+        return sink;
+    };
+    auto create_file = [&config, &formatter]() {
+        auto sink = CreateFileSink(config);
+        // 二进制文件sink不使用格式化器
+        if (config.GetLogLayout() != LogLayout::kBinary) {
+            sink->setFormatter(formatter);
+        }
+        return sink;
+    };
+
+    std::vector<std::shared_ptr<SinkInterface>> sinks;
+    for (const auto& spec : DescribeSinks(config)) {
+        if (spec.is_file) {
+            sinks.push_back(AcquireSink(spec.destination, spec.settings, create_file));
+        } else {
+            sinks.push_back(AcquireSink(spec.destination, spec.settings, create_console));
+        }
+    }
+    return sinks;
+}
+
+bool SinkRegistry::ReplacesSinks(const LogConfig& current, const LogConfig& next) const {
+    std::vector<SinkSpec> current_specs = DescribeSinks(current);
+    for (const auto& spec : DescribeSinks(next)) {
+        for (const auto& current_spec : current_specs) {
+            if (spec.destination == current_spec.destination && spec.settings != current_spec.settings) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<AsyncWriter> SinkRegistry::AcquireAsyncWriter(const std::vector<std::shared_ptr<SinkInterface>>& sinks,
+                                                              size_t queue_capacity, OverflowPolicy policy) {
+    // 以sink实例的地址标识写入目标，写入器持有sink，写入器存活期间地址不会被复用
+    std::string key = std::to_string(queue_capacity) + "|" + OverflowPolicyToString(policy);
+    for (const auto& sink : sinks) {
+        key.append(1, '|').append(std::to_string(reinterpret_cast<uintptr_t>(sink.get())));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RemoveExpired();
+
+    std::weak_ptr<AsyncWriter>& entry = async_writers_[key];
+    std::shared_ptr<AsyncWriter> writer = entry.lock();
+    if (!writer) {
+        writer = std::make_shared<AsyncWriter>(sinks, queue_capacity, policy);
+        entry = writer;
+    }
+    return writer;
+}
+
+std::vector<SinkStats> SinkRegistry::CollectStats() {
+    std::vector<SinkStats> stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [destination, entry] : sinks_) {
+        std::shared_ptr<SinkInterface> sink = entry.sink.lock();
+        if (sink) {
+            SinkStats& sink_stats = stats.emplace_back();
+            sink_stats.destination = destination;
+            sink->collectStats(sink_stats);
+        }
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const SinkStats& lhs, const SinkStats& rhs) { return lhs.destination < rhs.destination; });
+    return stats;
+}
+
+std::shared_ptr<SinkInterface> SinkRegistry::AcquireSink(
+    const std::string& destination, const std::string& settings,
+    const std::function<std::shared_ptr<SinkInterface>()>& create) {
+    SinkEntry& entry = sinks_[destination];
+    std::shared_ptr<SinkInterface> sink = entry.sink.lock();
+    if (!sink) {
+        sink = create();
+        entry.sink = sink;
+        entry.settings = settings;
+    } else if (entry.settings != settings) {
+        // 两个sink写同一文件会各自缓冲和滚动，互相覆盖，因此只能沿用已打开的sink
+        fprintf(stderr, "Log destination %s is already open with different settings, sharing the existing sink\n",
+                destination.c_str());
+    }
+    return sink;
+}
+
+std::shared_ptr<const Formatter> SinkRegistry::GetFormatter(LogLayout layout, TimestampPrecision precision) {
+    // 二进制格式只用于文件，控制台仍输出文本
+    if (layout == LogLayout::kBinary) {
+        layout = LogLayout::kText;
+    }
+    std::shared_ptr<const Formatter>& formatter =
+        formatters_[static_cast<int>(layout) * kFormatterStride + static_cast<int>(precision)];
+    if (!formatter) {
+        if (layout == LogLayout::kJson) {
+            formatter = std::make_shared<JsonFormatter>(precision);
+        } else {
+            formatter = std::make_shared<TextFormatter>(precision);
+        }
+    }
+    return formatter;
+}
+
+void SinkRegistry::RemoveExpired() {
+    for (auto it = sinks_.begin(); it != sinks_.end();) {
+        it = it->second.sink.expired() ? sinks_.erase(it) : std::next(it);
+    }
+    for (auto it = async_writers_.begin(); it != async_writers_.end();) {
+        it = it->second.expired() ? async_writers_.erase(it) : std::next(it);
+    }
+}
+
+}  // namespace tinylog::internal
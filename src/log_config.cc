@@ -10,7 +10,22 @@ LogConfig::LogConfig()
       file_path_(""),
       max_file_count_(kDefaultMaxFileCount),
       max_file_size_(kDefaultMaxFileSize),
-      async_mode_(kDefaultAsyncMode) {}
+      async_mode_(kDefaultAsyncMode),
+      async_queue_capacity_(kDefaultAsyncQueueCapacity),
+      overflow_policy_(kDefaultOverflowPolicy),
+      timestamp_precision_(kDefaultTimestampPrecision),
+      clock_source_(kDefaultClockSource),
+      file_buffer_size_(kDefaultFileBufferSize),
+      flush_interval_ms_(kDefaultFlushIntervalMs),
+      flush_level_(kDefaultFlushLevel),
+      rotation_mode_(kDefaultRotationMode),
+      compress_(kDefaultCompress),
+      max_total_size_(kDefaultMaxTotalSize),
+      file_engine_(kDefaultFileEngine),
+      layout_(kDefaultLogLayout),
+      rate_limit_(kDefaultRateLimit),
+      rate_limit_burst_(kDefaultRateLimitBurst),
+      deduplicate_(kDefaultDeduplicate) {}
 
 LogConfig::LogConfig(LogLevel level, LogSink sink, const std::string& file_path, int32_t max_file_count,
                      size_t max_file_size, bool async_mode)
@@ -19,7 +34,22 @@ LogConfig::LogConfig(LogLevel level, LogSink sink, const std::string& file_path,
       file_path_(file_path),
       max_file_count_(max_file_count),
       max_file_size_(max_file_size),
-      async_mode_(async_mode) {
+      async_mode_(async_mode),
+      async_queue_capacity_(kDefaultAsyncQueueCapacity),
+      overflow_policy_(kDefaultOverflowPolicy),
+      timestamp_precision_(kDefaultTimestampPrecision),
+      clock_source_(kDefaultClockSource),
+      file_buffer_size_(kDefaultFileBufferSize),
+      flush_interval_ms_(kDefaultFlushIntervalMs),
+      flush_level_(kDefaultFlushLevel),
+      rotation_mode_(kDefaultRotationMode),
+      compress_(kDefaultCompress),
+      max_total_size_(kDefaultMaxTotalSize),
+      file_engine_(kDefaultFileEngine),
+      layout_(kDefaultLogLayout),
+      rate_limit_(kDefaultRateLimit),
+      rate_limit_burst_(kDefaultRateLimitBurst),
+      deduplicate_(kDefaultDeduplicate) {
     Validate();
 }
 
@@ -55,6 +85,79 @@ void LogConfig::SetAsyncMode(bool async) { async_mode_ = async; }
 
 bool LogConfig::IsAsyncMode() const noexcept { return async_mode_; }
 
+void LogConfig::SetAsyncQueueCapacity(size_t capacity) {
+    if (IsValidQueueCapacity(capacity)) {
+        async_queue_capacity_ = capacity;
+    }
+}
+
+size_t LogConfig::GetAsyncQueueCapacity() const noexcept { return async_queue_capacity_; }
+
+void LogConfig::SetOverflowPolicy(OverflowPolicy policy) { overflow_policy_ = policy; }
+
+OverflowPolicy LogConfig::GetOverflowPolicy() const noexcept { return overflow_policy_; }
+
+void LogConfig::SetTimestampPrecision(TimestampPrecision precision) { timestamp_precision_ = precision; }
+
+TimestampPrecision LogConfig::GetTimestampPrecision() const noexcept { return timestamp_precision_; }
+
+void LogConfig::SetClockSource(ClockSource source) { clock_source_ = source; }
+
+ClockSource LogConfig::GetClockSource() const noexcept { return clock_source_; }
+
+void LogConfig::SetFileBufferSize(size_t size) {
+    if (IsValidFileBufferSize(size)) {
+        file_buffer_size_ = size;
+    }
+}
+
+size_t LogConfig::GetFileBufferSize() const noexcept { return file_buffer_size_; }
+
+void LogConfig::SetFlushIntervalMs(int64_t interval_ms) {
+    if (interval_ms >= 0) {
+        flush_interval_ms_ = interval_ms;
+    }
+}
+
+int64_t LogConfig::GetFlushIntervalMs() const noexcept { return flush_interval_ms_; }
+
+void LogConfig::SetFlushLevel(LogLevel level) { flush_level_ = level; }
+
+LogLevel LogConfig::GetFlushLevel() const noexcept { return flush_level_; }
+
+void LogConfig::SetRotationMode(RotationMode mode) { rotation_mode_ = mode; }
+
+RotationMode LogConfig::GetRotationMode() const noexcept { return rotation_mode_; }
+
+void LogConfig::SetCompress(bool compress) { compress_ = compress; }
+
+bool LogConfig::IsCompress() const noexcept { return compress_; }
+
+void LogConfig::SetMaxTotalSize(size_t size) { max_total_size_ = size; }
+
+size_t LogConfig::GetMaxTotalSize() const noexcept { return max_total_size_; }
+
+void LogConfig::SetFileEngine(FileEngine engine) { file_engine_ = engine; }
+
+FileEngine LogConfig::GetFileEngine() const noexcept { return file_engine_; }
+
+void LogConfig::SetLogLayout(LogLayout layout) { layout_ = layout; }
+
+LogLayout LogConfig::GetLogLayout() const noexcept { return layout_; }
+
+void LogConfig::SetRateLimit(uint32_t per_second, uint32_t burst) {
+    rate_limit_ = per_second;
+    rate_limit_burst_ = burst;
+}
+
+uint32_t LogConfig::GetRateLimit() const noexcept { return rate_limit_; }
+
+uint32_t LogConfig::GetRateLimitBurst() const noexcept { return rate_limit_burst_; }
+
+void LogConfig::SetDeduplicate(bool deduplicate) { deduplicate_ = deduplicate; }
+
+bool LogConfig::IsDeduplicate() const noexcept { return deduplicate_; }
+
 void LogConfig::ResetToDefault() {
     level_ = kDefaultLogLevel;
     sink_ = kDefaultLogSink;
@@ -62,10 +165,27 @@ void LogConfig::ResetToDefault() {
     max_file_count_ = kDefaultMaxFileCount;
     max_file_size_ = kDefaultMaxFileSize;
     async_mode_ = kDefaultAsyncMode;
+    async_queue_capacity_ = kDefaultAsyncQueueCapacity;
+    overflow_policy_ = kDefaultOverflowPolicy;
+    timestamp_precision_ = kDefaultTimestampPrecision;
+    clock_source_ = kDefaultClockSource;
+    file_buffer_size_ = kDefaultFileBufferSize;
+    flush_interval_ms_ = kDefaultFlushIntervalMs;
+    flush_level_ = kDefaultFlushLevel;
+    rotation_mode_ = kDefaultRotationMode;
+    compress_ = kDefaultCompress;
+    max_total_size_ = kDefaultMaxTotalSize;
+    file_engine_ = kDefaultFileEngine;
+    layout_ = kDefaultLogLayout;
+    rate_limit_ = kDefaultRateLimit;
+    rate_limit_burst_ = kDefaultRateLimitBurst;
+    deduplicate_ = kDefaultDeduplicate;
 }
 
 bool LogConfig::Validate() const {
-    return IsValidFileCount(max_file_count_) && IsValidFileSize(max_file_size_) && !file_path_.empty();
+    return IsValidFileCount(max_file_count_) && IsValidFileSize(max_file_size_) && !file_path_.empty() &&
+           IsValidQueueCapacity(async_queue_capacity_) && IsValidFileBufferSize(file_buffer_size_) &&
+           flush_interval_ms_ >= 0;
 }
 
 bool LogConfig::IsValidFileCount(int32_t count) const noexcept { return count >= 1 && count <= 100; }
@@ -74,4 +194,12 @@ bool LogConfig::IsValidFileSize(size_t size) const noexcept {
     return size >= 1024 && size <= 1024 * 1024 * 1024;  // 1KB - 1GB
 }
 
+bool LogConfig::IsValidQueueCapacity(size_t capacity) const noexcept {
+    return capacity >= 16 && capacity <= 1024 * 1024;  // 16 - 1M条
+}
+
+bool LogConfig::IsValidFileBufferSize(size_t size) const noexcept {
+    return size <= 64 * 1024 * 1024;  // 0 - 64MB，0表示不缓冲
+}
+
 }  // namespace tinylog
@@ -0,0 +1,311 @@
+#include "tinylog/log_format.h"
+
+#include <charconv>
+#include <cmath>
+#include <string>
+
+#include "tinylog/internal/json.h"
+
+namespace tinylog::internal {
+
+namespace {
+
+// 顺序读取二进制参数的游标
+class ArgReader {
+public:
+    explicit ArgReader(const ArgBuffer& args) : data_(args.data()), size_(args.size()) {}
+
+    // 是否还有格式参数，结构化字段位于所有格式参数之后
+    bool HasNext() const noexcept { return offset_ < size_ && data_[offset_] != static_cast<char>(ArgType::kField); }
+
+    // 跳过剩余的格式参数，数据不完整时返回false
+    bool SkipArgs() noexcept {
+        while (HasNext()) {
+            ArgType type;
+            if (!Read(&type, sizeof(type))) {
+                return false;
+            }
+            size_t length = 0;
+            switch (type) {
+                case ArgType::kBool:
+                case ArgType::kChar:
+                    length = 1;
+                    break;
+                case ArgType::kInt64:
+                case ArgType::kUInt64:
+                case ArgType::kDouble:
+                    length = 8;
+                    break;
+                case ArgType::kPointer:
+                    length = sizeof(uintptr_t);
+                    break;
+                case ArgType::kString: {
+                    uint32_t string_length;
+                    if (!Read(&string_length, sizeof(string_length))) {
+                        return false;
+                    }
+                    length = string_length;
+                    break;
+                }
+                default:
+                    return false;
+            }
+            if (offset_ + length > size_) {
+                return false;
+            }
+            offset_ += length;
+        }
+        return true;
+    }
+
+    // 读取下一个结构化字段的键，没有更多字段或数据不完整时返回false
+    bool NextField(std::string_view& key) noexcept {
+        ArgType type;
+        uint32_t length;
+        if (!Read(&type, sizeof(type)) || type != ArgType::kField || !Read(&length, sizeof(length)) ||
+            offset_ + length > size_) {
+            return false;
+        }
+        key = std::string_view(data_ + offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    // 以JSON值的形式读取下一个参数并追加到out：字符串、字符和指针加引号，非有限的浮点数输出为null
+    bool AppendNextJson(FormatBuffer& out) {
+        ArgType type;
+        if (offset_ >= size_) {
+            return false;
+        }
+        memcpy(&type, data_ + offset_, sizeof(type));
+        switch (type) {
+            case ArgType::kString: {
+                uint32_t length;
+                ++offset_;
+                if (!Read(&length, sizeof(length)) || offset_ + length > size_) {
+                    return false;
+                }
+                AppendJsonString(std::string_view(data_ + offset_, length), out);
+                offset_ += length;
+                return true;
+            }
+            case ArgType::kChar: {
+                char value;
+                ++offset_;
+                if (!Read(&value, sizeof(value))) {
+                    return false;
+                }
+                AppendJsonString(std::string_view(&value, 1), out);
+                return true;
+            }
+            case ArgType::kPointer: {
+                out.Append('"');
+                bool result = AppendNext(out);
+                out.Append('"');
+                return result;
+            }
+            case ArgType::kDouble: {
+                double value;
+                ++offset_;
+                if (!Read(&value, sizeof(value))) {
+                    return false;
+                }
+                if (!std::isfinite(value)) {
+                    out.Append(std::string_view("null"));
+                    return true;
+                }
+                return AppendNumber(out, value);
+            }
+            default:
+                return AppendNext(out);
+        }
+    }
+
+    // 读取下一个参数并追加到out，数据不完整时返回false。不分配内存，out为FixedBuffer时可在信号处理函数中使用
+    template <typename Buffer>
+    bool AppendNext(Buffer& out) {
+        ArgType type;
+        if (!Read(&type, sizeof(type))) {
+            return false;
+        }
+
+        switch (type) {
+            case ArgType::kBool: {
+                uint8_t value;
+                if (!Read(&value, sizeof(value))) {
+                    return false;
+                }
+                out.Append(std::string_view(value ? "true" : "false"));
+                return true;
+            }
+            case ArgType::kChar: {
+                char value;
+                if (!Read(&value, sizeof(value))) {
+                    return false;
+                }
+                out.Append(value);
+                return true;
+            }
+            case ArgType::kInt64: {
+                int64_t value;
+                return Read(&value, sizeof(value)) && AppendNumber(out, value);
+            }
+            case ArgType::kUInt64: {
+                uint64_t value;
+                return Read(&value, sizeof(value)) && AppendNumber(out, value);
+            }
+            case ArgType::kDouble: {
+                double value;
+                return Read(&value, sizeof(value)) && AppendNumber(out, value);
+            }
+            case ArgType::kPointer: {
+                uintptr_t value;
+                if (!Read(&value, sizeof(value))) {
+                    return false;
+                }
+                char buffer[2 + 2 * sizeof(value)] = {'0', 'x'};
+                auto result = std::to_chars(buffer + 2, buffer + sizeof(buffer), value, 16);
+                out.Append(buffer, static_cast<size_t>(result.ptr - buffer));
+                return true;
+            }
+            case ArgType::kString: {
+                uint32_t length;
+                if (!Read(&length, sizeof(length)) || offset_ + length > size_) {
+                    return false;
+                }
+                out.Append(data_ + offset_, length);
+                offset_ += length;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+private:
+    bool Read(void* value, size_t length) noexcept {
+        if (offset_ + length > size_) {
+            return false;
+        }
+        memcpy(value, data_ + offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    template <typename Buffer, typename T>
+    static bool AppendNumber(Buffer& out, T value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        out.Append(buffer, static_cast<size_t>(result.ptr - buffer));
+        return true;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+template <typename Buffer>
+void FormatArgsTo(std::string_view format, const ArgBuffer& args, Buffer& out) {
+    ArgReader reader(args);
+    size_t literal_start = 0;
+    size_t i = 0;
+    while (i < format.size()) {
+        char c = format[i];
+        if (c != '{' && c != '}') {
+            ++i;
+            continue;
+        }
+
+        out.Append(format.data() + literal_start, i - literal_start);
+        if (i + 1 < format.size() && format[i + 1] == c) {
+            // "{{"或"}}"，输出单个花括号
+            out.Append(c);
+            i += 2;
+        } else if (c == '{' && i + 1 < format.size() && format[i + 1] == '}') {
+            // 占位符，参数不足时原样保留
+            if (!reader.HasNext() || !reader.AppendNext(out)) {
+                out.Append(std::string_view("{}"));
+            }
+            i += 2;
+        } else {
+            out.Append(c);
+            ++i;
+        }
+        literal_start = i;
+    }
+    out.Append(format.data() + literal_start, format.size() - literal_start);
+}
+
+template <typename Buffer>
+void AppendTextFieldsTo(const ArgBuffer& args, Buffer& out) {
+    ArgReader reader(args);
+    if (!reader.SkipArgs()) {
+        return;
+    }
+    std::string_view key;
+    while (reader.NextField(key)) {
+        out.Append(' ');
+        out.Append(key);
+        out.Append('=');
+        if (!reader.AppendNext(out)) {
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+void FormatArgs(std::string_view format, const ArgBuffer& args, FormatBuffer& out) { FormatArgsTo(format, args, out); }
+
+void FormatArgs(std::string_view format, const ArgBuffer& args, FixedBuffer& out) noexcept {
+    FormatArgsTo(format, args, out);
+}
+
+void FormatArgs(const CallSite& site, const ArgBuffer& args, FormatBuffer& out) {
+    const FormatSpec& spec = site.spec;
+    if (!spec.valid || spec.has_escapes) {
+        FormatArgs(site.format, args, out);
+        return;
+    }
+
+    // 直接按预解析的占位符位置拼接字面量和参数
+    ArgReader reader(args);
+    size_t literal_start = 0;
+    for (size_t i = 0; i < spec.placeholder_count; ++i) {
+        size_t pos = spec.placeholder_pos[i];
+        out.Append(site.format + literal_start, pos - literal_start);
+        if (!reader.HasNext() || !reader.AppendNext(out)) {
+            out.Append(std::string_view("{}"));
+        }
+        literal_start = pos + 2;
+    }
+    out.Append(site.format + literal_start, spec.length - literal_start);
+}
+
+void AppendTextFields(const ArgBuffer& args, FormatBuffer& out) { AppendTextFieldsTo(args, out); }
+
+void AppendTextFields(const ArgBuffer& args, FixedBuffer& out) noexcept { AppendTextFieldsTo(args, out); }
+
+void AppendJsonFields(const ArgBuffer& args, FormatBuffer& out) {
+    ArgReader reader(args);
+    if (!reader.SkipArgs()) {
+        return;
+    }
+    std::string_view key;
+    while (reader.NextField(key)) {
+        out.Append(',');
+        AppendJsonString(key, out);
+        out.Append(':');
+        if (!reader.AppendNextJson(out)) {
+            // 值不完整时补上null，保持输出仍是合法的JSON
+            out.Append(std::string_view("null"));
+            return;
+        }
+    }
+}
+
+}  // namespace tinylog::internal
@@ -1,109 +1,300 @@
 #include "tinylog/log_manager.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "tinylog/internal/crash_handler.h"
+#include "tinylog/internal/sink_registry.h"
 #include "tinylog/logger.h"
 
 namespace tinylog {
 
+namespace {
+
+// 模块注册表：开放寻址哈希表，读取方无锁查找。
+// 表中已发布的项只增不改，容量不足时复制到两倍容量的新表后整体替换，旧表保留到日志管理器销毁，
+// 因此读取方持有的旧表始终有效，只是可能查不到刚加入的模块，此时由加锁的慢路径兜底
+class ModuleTable {
+public:
+    explicit ModuleTable(size_t capacity)
+        : capacity_(capacity), slots_(std::make_unique<std::atomic<const internal::ModuleEntry*>[]>(capacity)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    const internal::ModuleEntry* Find(std::string_view name, size_t hash) const {
+        size_t mask = capacity_ - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const internal::ModuleEntry* entry = slots_[i].load(std::memory_order_acquire);
+            if (entry == nullptr || entry->name == name) {
+                return entry;
+            }
+        }
+    }
+
+    // 只能由持有注册表锁的写入方调用
+    void Insert(const internal::ModuleEntry* entry, size_t hash) {
+        size_t mask = capacity_ - 1;
+        size_t i = hash & mask;
+        while (slots_[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & mask;
+        }
+        slots_[i].store(entry, std::memory_order_release);
+        ++size_;
+    }
+
+    // 负载因子不超过1/2，保证查找时总能遇到空槽
+    bool IsFull() const noexcept { return (size_ + 1) * 2 > capacity_; }
+
+    size_t Capacity() const noexcept { return capacity_; }
+
+    template <typename Function>
+    void ForEach(Function&& function) const {
+        for (size_t i = 0; i < capacity_; ++i) {
+            const internal::ModuleEntry* entry = slots_[i].load(std::memory_order_relaxed);
+            if (entry != nullptr) {
+                function(entry);
+            }
+        }
+    }
+
+private:
+    size_t capacity_;
+    size_t size_ = 0;
+    std::unique_ptr<std::atomic<const internal::ModuleEntry*>[]> slots_;
+};
+
+size_t HashModuleName(std::string_view name) { return std::hash<std::string_view>()(name); }
+
+// 串行化级别设置，保证节点状态在级别代数递增之前写入
+std::mutex g_level_mutex;
+
+}  // namespace
+
+namespace internal {
+
+std::atomic<uint64_t> g_level_generation{1};
+
+LogLevel ResolveLevel(const LevelNode& node) noexcept {
+    // 从节点向根节点查找，取设置代数最大的级别；代数相同时靠近节点的优先
+    uint64_t best = LevelNode::kUnset;
+    for (const LevelNode* current = &node; current != nullptr; current = current->parent) {
+        uint64_t state = current->state.load(std::memory_order_acquire);
+        if (state == LevelNode::kUnset) {
+            continue;
+        }
+        if (best == LevelNode::kUnset || (state >> LevelNode::kLevelBits) > (best >> LevelNode::kLevelBits)) {
+            best = state;
+        }
+    }
+    return best == LevelNode::kUnset ? LogLevel::kInfo : static_cast<LogLevel>(best & LevelNode::kLevelMask);
+}
+
+void SetNodeLevel(LevelNode& node, LogLevel level, bool override) {
+    std::lock_guard<std::mutex> lock(g_level_mutex);
+    uint64_t generation = g_level_generation.load(std::memory_order_relaxed) + 1;
+    uint64_t state_generation = generation;
+    if (!override) {
+        uint64_t state = node.state.load(std::memory_order_relaxed);
+        state_generation = state == LevelNode::kUnset ? 0 : state >> LevelNode::kLevelBits;
+    }
+    node.state.store((state_generation << LevelNode::kLevelBits) | static_cast<uint64_t>(level),
+                     std::memory_order_release);
+    g_level_generation.store(generation, std::memory_order_release);
+}
+
+}  // namespace internal
+
 // LogManager::Impl class definition
 class LogManager::Impl {
 public:
     Impl() {
         // 初始化全局日志实例
         global_logger_ = std::make_unique<Logger>();
+        internal::SetNodeLevel(root_level_, global_logger_->GetLogLevel(), false);
+        tables_.push_back(std::make_unique<ModuleTable>(kInitialModuleCapacity));
+        module_table_.store(tables_.back().get(), std::memory_order_release);
     }
 
     ~Impl() {
         // 清理所有日志实例
-        module_loggers_.clear();
+        module_table_.store(nullptr, std::memory_order_release);
+        module_entries_.clear();
+        tables_.clear();
         global_logger_.reset();
     }
 
+    // 无锁查找模块，未找到时返回空指针
+    const internal::ModuleEntry* FindModule(std::string_view name, size_t hash) const {
+        return module_table_.load(std::memory_order_acquire)->Find(name, hash);
+    }
+
+    // 加入新模块，调用方需持有module_loggers_mutex_
+    const internal::ModuleEntry& AddModule(std::unique_ptr<internal::ModuleEntry> entry, size_t hash) {
+        ModuleTable* table = tables_.back().get();
+        if (table->IsFull()) {
+            auto grown = std::make_unique<ModuleTable>(table->Capacity() * 2);
+            table->ForEach([&grown](const internal::ModuleEntry* existing) {
+                grown->Insert(existing, HashModuleName(existing->name));
+            });
+            tables_.push_back(std::move(grown));
+            table = tables_.back().get();
+        }
+        table->Insert(entry.get(), hash);
+        module_table_.store(table, std::memory_order_release);
+
+        module_entries_.push_back(std::move(entry));
+        return *module_entries_.back();
+    }
+
+    // 获取（必要时创建）模块及其各级父模块的级别节点，调用方需持有module_loggers_mutex_
+    internal::LevelNode* GetLevelNode(std::string_view name) {
+        auto it = level_nodes_.find(std::string(name));
+        if (it != level_nodes_.end()) {
+            return it->second.get();
+        }
+        size_t pos = name.rfind('.');
+        auto node = std::make_unique<internal::LevelNode>();
+        node->parent = pos == std::string_view::npos ? &root_level_ : GetLevelNode(name.substr(0, pos));
+        return level_nodes_.emplace(std::string(name), std::move(node)).first->second.get();
+    }
+
+    static constexpr size_t kInitialModuleCapacity = 64;
+
     // 全局日志实例
     std::unique_ptr<Logger> global_logger_;
 
-    // 模块日志实例映射
-    std::unordered_map<std::string, std::unique_ptr<Logger>> module_loggers_;
+    // 模块日志注册项，按创建顺序保存
+    std::vector<std::unique_ptr<internal::ModuleEntry>> module_entries_;
+
+    // 当前的模块注册表，以及所有替换下来的旧表
+    std::atomic<ModuleTable*> module_table_{nullptr};
+    std::vector<std::unique_ptr<ModuleTable>> tables_;
+
+    // 级别树：根节点对应全局级别，其余节点按模块名保存
+    internal::LevelNode root_level_;
+    std::unordered_map<std::string, std::unique_ptr<internal::LevelNode>> level_nodes_;
 
-    // 互斥锁，用于保护模块日志映射
+    // 互斥锁，用于保护模块和级别节点的创建和遍历
     std::mutex module_loggers_mutex_;
+
+    // 定期输出统计的后台线程
+    std::thread stats_thread_;
+    bool stats_running_ = false;
+    std::mutex stats_mutex_;
+    std::condition_variable stats_cv_;
 };
 
 // LogManager implementation
 LogManager::LogManager() { impl_ = std::make_unique<Impl>(); }
 
-LogManager::~LogManager() { impl_.reset(); }
+LogManager::~LogManager() {
+    // 统计线程通过impl_访问日志实例，需要在释放impl_之前退出
+    StopStatsDump();
+    impl_.reset();
+}
 
 LogManager& LogManager::GetInstance() {
     static LogManager instance;
     return instance;
 }
 
-void LogManager::InitGlobalLogger(const LogConfig& config) { impl_->global_logger_ = std::make_unique<Logger>(config); }
+void LogManager::InitGlobalLogger(const LogConfig& config) {
+    impl_->global_logger_ = std::make_unique<Logger>(config);
+    // 未设置级别的模块继承全局级别，但不覆盖已单独设置的模块级别
+    internal::SetNodeLevel(impl_->root_level_, impl_->global_logger_->GetLogLevel(), false);
+}
 
 void LogManager::InitGlobalLogger(const std::string& config_file_path) {
     impl_->global_logger_ = std::make_unique<Logger>(config_file_path);
+    internal::SetNodeLevel(impl_->root_level_, impl_->global_logger_->GetLogLevel(), false);
 }
 
 Logger& LogManager::GetGlobalLogger() { return *impl_->global_logger_; }
 
-Logger& LogManager::GetModuleLogger(const std::string& module_name) {
+Logger& LogManager::GetModuleLogger(std::string_view module_name) { return *GetModuleEntry(module_name).logger; }
+
+Logger& LogManager::GetModuleLogger(std::string_view module_name, const LogConfig& config) {
+    size_t hash = HashModuleName(module_name);
     std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
 
-    // 查找模块日志实例
-    auto it = impl_->module_loggers_.find(module_name);
-    if (it != impl_->module_loggers_.end()) {
-        return *it->second;
+    // 如果存在，更新配置
+    const internal::ModuleEntry* entry = impl_->FindModule(module_name, hash);
+    if (entry != nullptr) {
+        entry->logger->SetConfig(config);
+        return *entry->logger;
     }
 
     // 如果不存在，创建新的模块日志实例
-    auto logger = std::make_unique<Logger>();
-    Logger& logger_ref = *logger;
-    impl_->module_loggers_[module_name] = std::move(logger);
-
-    return logger_ref;
+    return *impl_->AddModule(CreateModuleEntry(module_name, impl_->GetLevelNode(module_name), &config), hash).logger;
 }
 
-Logger& LogManager::GetModuleLogger(const std::string& module_name, const LogConfig& config) {
-    std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
-
-    // 查找模块日志实例
-    auto it = impl_->module_loggers_.find(module_name);
-    if (it != impl_->module_loggers_.end()) {
-        // 如果存在，更新配置
-        it->second->SetConfig(config);
-        return *it->second;
+const internal::ModuleEntry& LogManager::GetModuleEntry(std::string_view module_name) {
+    // 快速路径：无锁查找已存在的模块
+    size_t hash = HashModuleName(module_name);
+    const internal::ModuleEntry* entry = impl_->FindModule(module_name, hash);
+    if (entry != nullptr) {
+        return *entry;
     }
 
-    // 如果不存在，创建新的模块日志实例
-    auto logger = std::make_unique<Logger>(config);
-    Logger& logger_ref = *logger;
-    impl_->module_loggers_[module_name] = std::move(logger);
+    // 慢路径：加锁后再次查找，仍不存在时创建新的模块日志实例
+    std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
+    entry = impl_->FindModule(module_name, hash);
+    if (entry != nullptr) {
+        return *entry;
+    }
+    return impl_->AddModule(CreateModuleEntry(module_name, impl_->GetLevelNode(module_name), nullptr), hash);
+}
 
-    return logger_ref;
+std::unique_ptr<internal::ModuleEntry> LogManager::CreateModuleEntry(std::string_view module_name,
+                                                                    internal::LevelNode* level_node,
+                                                                    const LogConfig* config) {
+    // 模块名和级别节点在发布到注册表之前写入日志实例，无锁读取方看到的日志实例总是完整的
+    auto entry = std::make_unique<internal::ModuleEntry>();
+    entry->name = std::string(module_name);
+    entry->level_node = level_node;
+    entry->logger = std::make_unique<Logger>(config != nullptr ? *config : LogConfig());
+    entry->logger->module_name_ = entry->name;
+    entry->logger->level_node_ = level_node;
+    if (config != nullptr) {
+        internal::SetNodeLevel(*level_node, config->GetLogLevel());
+    }
+    return entry;
 }
 
 void LogManager::SetGlobalLogLevel(LogLevel level) {
     impl_->global_logger_->SetLogLevel(level);
 
-    // 同时更新所有模块日志的级别
-    std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
-    for (auto& pair : impl_->module_loggers_) {
-        pair.second->SetLogLevel(level);
+    // 根节点的新设置覆盖此前所有模块的设置，各模块日志在下次记录时发现级别代数变化后重新计算
+    internal::SetNodeLevel(impl_->root_level_, level);
+}
+
+void LogManager::SetModuleLogLevel(std::string_view module_name, LogLevel level) {
+    internal::LevelNode* node = nullptr;
+    const internal::ModuleEntry* entry = impl_->FindModule(module_name, HashModuleName(module_name));
+    if (entry != nullptr) {
+        node = entry->level_node;
+    } else {
+        std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
+        node = impl_->GetLevelNode(module_name);
     }
+    internal::SetNodeLevel(*node, level);
 }
 
-void LogManager::SetModuleLogLevel(const std::string& module_name, LogLevel level) {
+LogLevel LogManager::GetModuleLogLevel(std::string_view module_name) {
     std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
-
-    auto it = impl_->module_loggers_.find(module_name);
-    if (it != impl_->module_loggers_.end()) {
-        it->second->SetLogLevel(level);
-    }
+    return internal::ResolveLevel(*impl_->GetLevelNode(module_name));
 }
 
 void LogManager::FlushAll() {
@@ -112,9 +303,63 @@ void LogManager::FlushAll() {
 
     // 刷新所有模块日志
     std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
-    for (auto& pair : impl_->module_loggers_) {
-        pair.second->Flush();
+    for (const auto& entry : impl_->module_entries_) {
+        entry->logger->Flush();
+    }
+}
+
+LogStats LogManager::GetStats() {
+    LogStats stats;
+    stats.loggers.push_back(impl_->global_logger_->GetStats());
+    {
+        std::lock_guard<std::mutex> lock(impl_->module_loggers_mutex_);
+        for (const auto& entry : impl_->module_entries_) {
+            stats.loggers.push_back(entry->logger->GetStats());
+        }
+    }
+    stats.sinks = internal::SinkRegistry::GetInstance().CollectStats();
+    return stats;
+}
+
+void LogManager::DumpStats() {
+    // 先取快照再获取统计模块的日志实例，首次输出时新建的模块不出现在本次快照中
+    std::string text = GetStats().ToString();
+    Logger& logger = GetModuleLogger(kStatsModule);
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        logger.LogInfo(text.substr(start, end - start), __FILE__, __FUNCTION__, __LINE__);
+        start = end + 1;
+    }
+}
+
+void LogManager::StartStatsDump(std::chrono::milliseconds interval) {
+    StopStatsDump();
+    std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
+    impl_->stats_running_ = true;
+    impl_->stats_thread_ = std::thread([this, interval] {
+        std::unique_lock<std::mutex> stats_lock(impl_->stats_mutex_);
+        while (!impl_->stats_cv_.wait_for(stats_lock, interval, [this] { return !impl_->stats_running_; })) {
+            stats_lock.unlock();
+            DumpStats();
+            stats_lock.lock();
+        }
+    });
+}
+
+void LogManager::StopStatsDump() {
+    std::thread stats_thread;
+    {
+        std::lock_guard<std::mutex> lock(impl_->stats_mutex_);
+        impl_->stats_running_ = false;
+        stats_thread = std::move(impl_->stats_thread_);
+    }
+    impl_->stats_cv_.notify_all();
+    if (stats_thread.joinable()) {
+        stats_thread.join();
     }
 }
 
+void LogManager::InstallCrashHandler() { internal::InstallCrashHandler(); }
+
 }  // namespace tinylog
@@ -0,0 +1,70 @@
+#include "tinylog/log_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tinylog {
+
+namespace internal {
+
+namespace {
+
+std::atomic<size_t> g_next_counter_stripe{0};
+
+}  // namespace
+
+size_t NextCounterStripe() noexcept { return g_next_counter_stripe.fetch_add(1, std::memory_order_relaxed); }
+
+}  // namespace internal
+
+uint64_t SinkStats::FlushLatencyPercentileUs(double fraction) const noexcept {
+    uint64_t total = 0;
+    for (uint64_t count : flush_latency_us) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // 第fraction比例的样本所在的桶，返回该桶的上界
+    uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total))), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kFlushLatencyBuckets; ++i) {
+        seen += flush_latency_us[i];
+        if (seen >= target) {
+            return uint64_t{1} << i;
+        }
+    }
+    return uint64_t{1} << (kFlushLatencyBuckets - 1);
+}
+
+std::string LogStats::ToString() const {
+    std::string text;
+    for (const auto& logger : loggers) {
+        text.append("logger=").append(logger.module.empty() ? "global" : logger.module);
+        text.append(" accepted=").append(std::to_string(logger.accepted));
+        text.append(" filtered=").append(std::to_string(logger.filtered));
+        text.append(" dropped=").append(std::to_string(logger.dropped));
+        text.append(" suppressed=").append(std::to_string(logger.suppressed));
+        if (logger.queue_capacity != 0) {
+            text.append(" queue_high_water=").append(std::to_string(logger.queue_high_water));
+            text.append(" queue_capacity=").append(std::to_string(logger.queue_capacity));
+        }
+        text.append(1, '\n');
+    }
+    for (const auto& sink : sinks) {
+        text.append("sink=").append(sink.destination);
+        text.append(" bytes=").append(std::to_string(sink.bytes_written));
+        text.append(" write_calls=").append(std::to_string(sink.write_calls));
+        text.append(" rotations=").append(std::to_string(sink.rotations));
+        text.append(" dropped=").append(std::to_string(sink.dropped));
+        text.append(" flushes=").append(std::to_string(sink.flushes));
+        text.append(" flush_p50_us=").append(std::to_string(sink.FlushLatencyPercentileUs(0.5)));
+        text.append(" flush_p99_us=").append(std::to_string(sink.FlushLatencyPercentileUs(0.99)));
+        text.append(" flush_max_us=").append(std::to_string(sink.FlushLatencyPercentileUs(1.0)));
+        text.append(1, '\n');
+    }
+    return text;
+}
+
+}  // namespace tinylog
@@ -1,41 +1,163 @@
 #include "tinylog/logger.h"
 
-#include <chrono>
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
-#include <thread>
+#include <functional>
+#include <string_view>
 
+#include "tinylog/internal/async_writer.h"
+#include "tinylog/internal/config_watcher.h"
+#include "tinylog/internal/crash_handler.h"
+#include "tinylog/internal/epoch.h"
 #include "tinylog/internal/log_utils.h"
 #include "tinylog/internal/sink_interface.h"
+#include "tinylog/internal/sink_registry.h"
 
 namespace tinylog {
 
-Logger::Logger(const LogConfig& config) : config_(config) { InitSinks(); }
+namespace {
 
-Logger::Logger(const std::string& config_file_path) : config_file_path_(config_file_path) {
-    LoadConfigFromFile(config_file_path);
+// 同步模式下复用的线程私有日志事件，消息字符串的容量在多条日志之间复用。
+// 只有直接给出消息内容的日志会使用它，因此format和args始终保持为空
+internal::LogEvent& GetScratchEvent() {
+    thread_local internal::LogEvent event;
+    return event;
+}
+
+// 连续重复的日志至多间隔该时间报告一次重复次数
+constexpr int64_t kRepeatReportIntervalNs = 1000000000;
+
+// 没有调用点描述符的日志（Logger::Log、Info等）按文件名地址和行号查找限流状态。
+// 固定大小的开放寻址表，读取和插入都不加锁：插入方以CAS占用空槽，项一经插入不再删除；
+// 探测次数用尽（表接近满）时返回空，对应的日志不限流
+class SiteLimiterTable {
+public:
+    internal::SiteLimiter* Find(const char* filename, int line) noexcept {
+        if (filename == nullptr) {
+            return nullptr;
+        }
+        // 用户态地址不超过48位，行号放在高16位
+        uint64_t key = reinterpret_cast<uintptr_t>(filename) ^ (static_cast<uint64_t>(line) << 48);
+        size_t index = static_cast<size_t>((key ^ (key >> 17)) * 0x9E3779B97F4A7C15ULL >> 54);
+        for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+            Slot& slot = slots_[(index + probe) & (kCapacity - 1)];
+            uint64_t current = slot.key.load(std::memory_order_acquire);
+            if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                return &slot.limiter;
+            }
+            if (current == key) {
+                return &slot.limiter;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static constexpr size_t kCapacity = 1024;
+    static constexpr size_t kMaxProbes = 16;
+
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        internal::SiteLimiter limiter;
+    };
+
+    Slot slots_[kCapacity];
+};
+
+SiteLimiterTable& GetSiteLimiterTable() {
+    static SiteLimiterTable table;
+    return table;
+}
+
+// 去重比较的日志内容：延迟格式化的日志比较参数的二进制编码
+uint64_t HashContent(const internal::LogEvent& event) {
+    std::string_view content = event.Format() != nullptr ? event.args.view() : std::string_view(event.message);
+    uint64_t hash = std::hash<std::string_view>()(content);
+    return hash != 0 ? hash : 1;
+}
+
+}  // namespace
+
+struct Logger::State {
+    LogConfig config;
+    std::vector<std::shared_ptr<internal::SinkInterface>> sinks;
+    // 异步写入器，仅在异步模式下获取
+    std::shared_ptr<internal::AsyncWriter> async_writer;
+    // 按配置预先计算的限流参数：每条日志消耗的时间和允许的突发时间，interval为0表示不限流
+    int64_t rate_interval_ns = 0;
+    int64_t rate_tolerance_ns = 0;
+    bool deduplicate = false;
+
+    bool Throttled() const noexcept { return rate_interval_ns > 0 || deduplicate; }
+};
+
+Logger::Logger(const LogConfig& config)
+    : config_(config), level_(config.GetLogLevel()), epoch_(std::make_unique<internal::EpochDomain>()) {
+    InitSinks();
+}
+
+Logger::Logger(const std::string& config_file_path)
+    : config_file_path_(config_file_path), epoch_(std::make_unique<internal::EpochDomain>()) {
+    LoadConfigFromFile(config_file_path, config_);
+    level_.store(config_.GetLogLevel(), std::memory_order_relaxed);
     InitSinks();
     StartConfigFileMonitor();
 }
 
-Logger::Logger(Logger&& other) noexcept
-    : config_(std::move(other.config_)),
-      config_file_path_(std::move(other.config_file_path_)),
-      sinks_(std::move(other.sinks_)),
-      is_monitoring_(other.is_monitoring_),
-      config_monitor_thread_(std::move(other.config_monitor_thread_)) {
-    other.is_monitoring_ = false;
+Logger::Logger(Logger&& other)
+    : level_node_(other.level_node_), module_name_(other.module_name_) {
+    // 监控回调绑定了原对象且会读取配置和替换快照，先取消原对象的监控再移动，之后为新对象重新注册
+    bool watching = other.config_watch_id_ != 0;
+    other.StopConfigFileMonitor();
+    config_ = std::move(other.config_);
+    config_file_path_ = std::move(other.config_file_path_);
+    level_.store(other.level_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    state_.store(other.state_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+    state_owner_ = std::move(other.state_owner_);
+    epoch_ = std::move(other.epoch_);
+    dropped_count_.store(other.dropped_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    counters_.CopyFrom(other.counters_);
+    {
+        std::lock_guard<std::mutex> lock(other.pending_mutex_);
+        pending_reports_ = std::move(other.pending_reports_);
+    }
+    if (watching) {
+        StartConfigFileMonitor();
+    }
 }
 
-Logger& Logger::operator=(Logger&& other) noexcept {
+Logger& Logger::operator=(Logger&& other) {
     if (this != &other) {
+        bool watching = other.config_watch_id_ != 0;
+        StopConfigFileMonitor();
+        other.StopConfigFileMonitor();
+        // 本对象的快照即将被替换，先补报其尚未报告的抑制数量
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            if (state_owner_ != nullptr) {
+                ReportPending(*state_owner_);
+            }
+        }
         config_ = std::move(other.config_);
         config_file_path_ = std::move(other.config_file_path_);
-        sinks_ = std::move(other.sinks_);
-        is_monitoring_ = other.is_monitoring_;
-        config_monitor_thread_ = std::move(other.config_monitor_thread_);
-        other.is_monitoring_ = false;
+        level_.store(other.level_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        level_node_ = other.level_node_;
+        level_cache_.store(0, std::memory_order_relaxed);
+        module_name_ = other.module_name_;
+        state_.store(other.state_.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        state_owner_ = std::move(other.state_owner_);
+        epoch_ = std::move(other.epoch_);
+        dropped_count_.store(other.dropped_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        counters_.CopyFrom(other.counters_);
+        {
+            std::scoped_lock lock(pending_mutex_, other.pending_mutex_);
+            pending_reports_ = std::move(other.pending_reports_);
+        }
+        if (watching) {
+            StartConfigFileMonitor();
+        }
     }
     return *this;
 }
@@ -46,25 +168,233 @@ Logger::~Logger() {
 }
 
 void Logger::Log(LogLevel level, const std::string& message, const char* filename, const char* function, int line) {
+    // 检查日志级别是否高于配置的级别，无需加锁
+    if (!ShouldLog(level)) {
+        CountFiltered();
+        return;
+    }
+
+    WithState([&](const State& state) {
+        // 创建日志事件，同步模式下复用线程私有的事件以免每条日志分配内存
+        internal::LogEvent local_event;
+        internal::LogEvent& event = state.async_writer ? local_event : GetScratchEvent();
+        event.message.assign(message);
+        event.level = level;
+        event.timestamp = internal::GetCurrentTimeNanos(state.config.GetClockSource());
+        event.filename = filename;
+        event.function = function;
+        event.line = line;
+        event.site = nullptr;
+
+        if (!AdmitEvent(state, state.Throttled() ? GetSiteLimiterTable().Find(filename, line) : nullptr, event)) {
+            return;
+        }
+        DispatchEvent(state, std::move(event));
+    });
+}
+
+void Logger::Log(const internal::CallSite& site, const std::string& message) {
+    if (!ShouldLog(site.level)) {
+        CountFiltered();
+        return;
+    }
+
+    WithState([&](const State& state) {
+        internal::LogEvent local_event;
+        internal::LogEvent& event = state.async_writer ? local_event : GetScratchEvent();
+        event.message.assign(message);
+        event.level = site.level;
+        event.timestamp = internal::GetCurrentTimeNanos(state.config.GetClockSource());
+        event.site = &site;
+
+        if (!AdmitEvent(state, site.limiter, event)) {
+            return;
+        }
+        DispatchEvent(state, std::move(event));
+    });
+}
+
+void Logger::LogFormatted(const internal::CallSite& site, internal::ArgBuffer&& args) {
+    WithState([&](const State& state) {
+        internal::LogEvent event;
+        event.level = site.level;
+        event.timestamp = internal::GetCurrentTimeNanos(state.config.GetClockSource());
+        event.site = &site;
+        event.args = std::move(args);
+
+        if (!AdmitEvent(state, site.limiter, event)) {
+            return;
+        }
+        DispatchEvent(state, std::move(event));
+    });
+}
+
+void Logger::LogFormatted(LogLevel level, const FormatString& fmt, internal::ArgBuffer&& args) {
+    WithState([&](const State& state) {
+        internal::LogEvent event;
+        event.level = level;
+        event.timestamp = internal::GetCurrentTimeNanos(state.config.GetClockSource());
+        event.filename = fmt.filename;
+        event.function = fmt.function;
+        event.line = fmt.line;
+        event.args = std::move(args);
+        // 去重按日志内容比较，需在AdmitEvent之前确定格式字符串或格式化结果
+        if (fmt.literal) {
+            event.format = fmt.format;
+        } else {
+            // 非字面量的格式字符串在调用返回后可能失效，立即格式化，结构化字段仍保留在args中
+            internal::FormatBuffer message;
+            internal::FormatArgs(fmt.view(), event.args, message);
+            event.message.assign(message.view());
+        }
+
+        internal::SiteLimiter* limiter =
+            state.Throttled() ? GetSiteLimiterTable().Find(fmt.filename, fmt.line) : nullptr;
+        if (!AdmitEvent(state, limiter, event)) {
+            return;
+        }
+        DispatchEvent(state, std::move(event));
+    });
+}
+
+template <typename Function>
+void Logger::WithState(Function&& function) {
+    // 已被移动的日志实例不再记录
+    if (epoch_ == nullptr) {
+        return;
+    }
+    {
+        internal::EpochGuard guard(*epoch_);
+        const State* state = state_.load(std::memory_order_acquire);
+        if (state != nullptr) {
+            function(*state);
+            return;
+        }
+    }
+    // 快照暂时为空说明参数改变的sink正在替换，等待替换完成后在锁内记录
     std::lock_guard<std::mutex> lock(config_mutex_);
+    if (state_owner_ != nullptr) {
+        function(*state_owner_);
+    }
+}
+
+bool Logger::AdmitEvent(const State& state, internal::SiteLimiter* limiter, const internal::LogEvent& event) {
+    if (limiter == nullptr || !state.Throttled()) {
+        counters_.Add(kAcceptedCounter);
+        return true;
+    }
+    int64_t now = event.timestamp;
+
+    // 与本调用点上一条日志内容相同时只计数，首次重复后至多每秒报告一次重复次数
+    if (state.deduplicate) {
+        uint64_t hash = HashContent(event);
+        if (limiter->last_hash.exchange(hash, std::memory_order_relaxed) == hash) {
+            if (limiter->repeated.fetch_add(1, std::memory_order_relaxed) == 0) {
+                limiter->repeat_report_ns.store(now + kRepeatReportIntervalNs, std::memory_order_relaxed);
+                AddPendingReport(limiter, event);
+            } else if (now >= limiter->repeat_report_ns.load(std::memory_order_relaxed)) {
+                ReportSuppressed(state, event, limiter->repeated.exchange(0, std::memory_order_relaxed), true);
+            }
+            counters_.Add(kSuppressedCounter);
+            return false;
+        }
+        if (limiter->repeated.load(std::memory_order_relaxed) != 0) {
+            ReportSuppressed(state, event, limiter->repeated.exchange(0, std::memory_order_relaxed), true);
+        }
+    }
+
+    // 令牌桶以GCRA实现：next_allowed_ns为按限流速率下一条日志的理论时间，
+    // 超前当前时间不超过突发容量时放行并推后一个间隔，只需一个原子变量的CAS
+    if (state.rate_interval_ns > 0) {
+        int64_t next_allowed = limiter->next_allowed_ns.load(std::memory_order_relaxed);
+        for (;;) {
+            int64_t base = std::max(next_allowed, now);
+            if (base - now > state.rate_tolerance_ns) {
+                if (limiter->rate_limited.fetch_add(1, std::memory_order_relaxed) == 0) {
+                    AddPendingReport(limiter, event);
+                }
+                counters_.Add(kSuppressedCounter);
+                return false;
+            }
+            if (limiter->next_allowed_ns.compare_exchange_weak(next_allowed, base + state.rate_interval_ns,
+                                                               std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        if (limiter->rate_limited.load(std::memory_order_relaxed) != 0) {
+            ReportSuppressed(state, event, limiter->rate_limited.exchange(0, std::memory_order_relaxed), false);
+        }
+    }
+    counters_.Add(kAcceptedCounter);
+    return true;
+}
 
-    // 检查日志级别是否高于配置的级别
-    if (level < config_.GetLogLevel()) {
+void Logger::ReportSuppressed(const State& state, const internal::LogEvent& event, uint64_t count, bool repeated) {
+    if (count == 0) {
         return;
     }
+    internal::LogEvent notice;
+    notice.level = event.level;
+    notice.timestamp = event.timestamp;
+    notice.filename = event.Filename();
+    notice.function = event.Function();
+    notice.line = event.Line();
+    if (repeated) {
+        notice.message.append("last message repeated ").append(std::to_string(count)).append(" times");
+    } else {
+        notice.message.append(std::to_string(count)).append(" messages suppressed by rate limit");
+    }
+    DispatchEvent(state, std::move(notice));
+}
 
-    // 创建日志事件
-    internal::LogEvent event;
-    event.message = message;
-    event.level = level;
-    event.timestamp = time(nullptr);
-    event.filename = filename;
-    event.function = function;
-    event.line = line;
+void Logger::AddPendingReport(internal::SiteLimiter* limiter, const internal::LogEvent& event) {
+    // 只在一段抑制开始时调用，不在每条被抑制的日志上加锁
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    for (const auto& report : pending_reports_) {
+        if (report.limiter == limiter) {
+            return;
+        }
+    }
+    pending_reports_.push_back({limiter, event.level, event.Filename(), event.Function(), event.Line()});
+}
 
-    // 向所有sink发送日志
-    for (const auto& sink : sinks_) {
-        sink->log(event);
+void Logger::ReportPending(const State& state) {
+    std::vector<PendingReport> reports;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        reports = pending_reports_;
+    }
+    for (const auto& report : reports) {
+        internal::LogEvent event;
+        event.level = report.level;
+        event.timestamp = internal::GetCurrentTimeNanos(state.config.GetClockSource());
+        event.filename = report.filename;
+        event.function = report.function;
+        event.line = report.line;
+        ReportSuppressed(state, event, report.limiter->repeated.exchange(0, std::memory_order_relaxed), true);
+        ReportSuppressed(state, event, report.limiter->rate_limited.exchange(0, std::memory_order_relaxed), false);
+    }
+}
+
+void Logger::DispatchEvent(const State& state, internal::LogEvent&& event) {
+    event.module = module_name_;
+    internal::PrepareCrashThread();
+    bool fatal = event.level == LogLevel::kFatal;
+
+    if (state.async_writer) {
+        // 异步模式下交给后台线程写入
+        size_t dropped = state.async_writer->Enqueue(std::move(event));
+        if (dropped != 0) {
+            dropped_count_.fetch_add(dropped, std::memory_order_relaxed);
+        }
+    } else {
+        // 向所有sink发送日志
+        internal::SinkInterface::dispatch(event, state.sinks);
+    }
+
+    // 安装了崩溃处理时，kFatal日志写出后终止进程
+    if (fatal) {
+        internal::HandleFatal();
     }
 }
 
@@ -91,11 +421,19 @@ void Logger::LogFatal(const std::string& message, const char* filename, const ch
 void Logger::SetLogLevel(LogLevel level) {
     std::lock_guard<std::mutex> lock(config_mutex_);
     config_.SetLogLevel(level);
+    level_.store(level, std::memory_order_relaxed);
+    if (level_node_ != nullptr) {
+        internal::SetNodeLevel(*level_node_, level);
+    }
 }
 
-LogLevel Logger::GetLogLevel() const {
-    std::lock_guard<std::mutex> lock(config_mutex_);
-    return config_.GetLogLevel();
+LogLevel Logger::GetLogLevel() const { return EffectiveLevel(); }
+
+LogLevel Logger::RefreshLevel(uint64_t generation) const noexcept {
+    LogLevel level = internal::ResolveLevel(*level_node_);
+    level_cache_.store((generation << internal::LevelNode::kLevelBits) | static_cast<uint64_t>(level),
+                       std::memory_order_relaxed);
+    return level;
 }
 
 void Logger::SetLogSink(LogSink sink) {
@@ -113,17 +451,48 @@ void Logger::SetConfig(const LogConfig& config) {
     std::lock_guard<std::mutex> lock(config_mutex_);
     config_ = config;
     ValidateConfig();
+    // 新快照发布后再修改级别，按新级别记录的日志不会写入旧的输出目标
     ReInitSinks();
+    level_.store(config_.GetLogLevel(), std::memory_order_relaxed);
+    if (level_node_ != nullptr) {
+        internal::SetNodeLevel(*level_node_, config_.GetLogLevel());
+    }
 }
 
 void Logger::Flush() {
     std::lock_guard<std::mutex> lock(config_mutex_);
-    for (const auto& sink : sinks_) {
+    if (state_owner_ == nullptr) {
+        return;
+    }
+    ReportPending(*state_owner_);
+    if (state_owner_->async_writer) {
+        state_owner_->async_writer->Flush();
+        return;
+    }
+    for (const auto& sink : state_owner_->sinks) {
         sink->flush();
     }
 }
 
-void Logger::LoadConfigFromFile(const std::string& config_file_path) {
+uint64_t Logger::GetDroppedCount() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+LoggerStats Logger::GetStats() const {
+    LoggerStats stats;
+    stats.module = std::string(module_name_);
+    stats.accepted = counters_.Sum(kAcceptedCounter);
+    stats.filtered = counters_.Sum(kFilteredCounter);
+    stats.suppressed = counters_.Sum(kSuppressedCounter);
+    stats.dropped = dropped_count_.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (state_owner_ != nullptr && state_owner_->async_writer) {
+        stats.queue_capacity = state_owner_->config.GetAsyncQueueCapacity();
+        stats.queue_high_water = state_owner_->async_writer->GetQueueHighWater();
+    }
+    return stats;
+}
+
+void Logger::LoadConfigFromFile(const std::string& config_file_path, LogConfig& config) {
     std::ifstream file(config_file_path);
     if (!file.is_open()) {
         fprintf(stderr, "Failed to open config file: %s\n", config_file_path.c_str());
@@ -150,25 +519,79 @@ void Logger::LoadConfigFromFile(const std::string& config_file_path) {
 
         // 设置配置
         if (key == "log_level") {
-            config_.SetLogLevel(internal::StringToLogLevel(value));
+            config.SetLogLevel(internal::StringToLogLevel(value));
         } else if (key == "log_sink") {
-            config_.SetLogSink(internal::StringToLogSink(value));
+            config.SetLogSink(internal::StringToLogSink(value));
         } else if (key == "file_path") {
-            config_.SetFilePath(value);
+            config.SetFilePath(value);
         } else if (key == "max_file_count") {
             try {
-                config_.SetMaxFileCount(std::stoi(value));
+                config.SetMaxFileCount(std::stoi(value));
             } catch (...) {
                 // 忽略无效值
             }
         } else if (key == "max_file_size") {
             try {
-                config_.SetMaxFileSize(std::stoul(value));
+                config.SetMaxFileSize(std::stoul(value));
             } catch (...) {
                 // 忽略无效值
             }
         } else if (key == "async_mode") {
-            config_.SetAsyncMode(value == "true" || value == "1");
+            config.SetAsyncMode(value == "true" || value == "1");
+        } else if (key == "async_queue_capacity") {
+            try {
+                config.SetAsyncQueueCapacity(std::stoul(value));
+            } catch (...) {
+                // 忽略无效值
+            }
+        } else if (key == "async_overflow_policy") {
+            config.SetOverflowPolicy(internal::StringToOverflowPolicy(value));
+        } else if (key == "timestamp_precision") {
+            config.SetTimestampPrecision(internal::StringToTimestampPrecision(value));
+        } else if (key == "clock_source") {
+            config.SetClockSource(internal::StringToClockSource(value));
+        } else if (key == "file_buffer_size") {
+            try {
+                config.SetFileBufferSize(std::stoul(value));
+            } catch (...) {
+                // 忽略无效值
+            }
+        } else if (key == "flush_interval_ms") {
+            try {
+                config.SetFlushIntervalMs(std::stoll(value));
+            } catch (...) {
+                // 忽略无效值
+            }
+        } else if (key == "flush_level") {
+            config.SetFlushLevel(internal::StringToLogLevel(value));
+        } else if (key == "rotation_mode") {
+            config.SetRotationMode(internal::StringToRotationMode(value));
+        } else if (key == "compress") {
+            config.SetCompress(value == "true" || value == "1");
+        } else if (key == "file_engine") {
+            config.SetFileEngine(internal::StringToFileEngine(value));
+        } else if (key == "log_layout") {
+            config.SetLogLayout(internal::StringToLogLayout(value));
+        } else if (key == "rate_limit") {
+            try {
+                config.SetRateLimit(static_cast<uint32_t>(std::stoul(value)), config.GetRateLimitBurst());
+            } catch (...) {
+                // 忽略无效值
+            }
+        } else if (key == "rate_limit_burst") {
+            try {
+                config.SetRateLimit(config.GetRateLimit(), static_cast<uint32_t>(std::stoul(value)));
+            } catch (...) {
+                // 忽略无效值
+            }
+        } else if (key == "deduplicate") {
+            config.SetDeduplicate(value == "true" || value == "1");
+        } else if (key == "max_total_size") {
+            try {
+                config.SetMaxTotalSize(std::stoull(value));
+            } catch (...) {
+                // 忽略无效值
+            }
         }
     }
 
@@ -176,25 +599,41 @@ void Logger::LoadConfigFromFile(const std::string& config_file_path) {
 }
 
 void Logger::InitSinks() {
-    sinks_.clear();
-
-    // 根据配置创建日志输出目标
-    switch (config_.GetLogSink()) {
-        case LogSink::kConsole:
-            sinks_.emplace_back(std::make_shared<internal::ConsoleSink>());
-            break;
-        case LogSink::kFile:
-            sinks_.emplace_back(std::make_shared<internal::FileSink>(config_.GetFilePath(), config_.GetMaxFileCount(),
-                                                                     config_.GetMaxFileSize()));
-            break;
-        case LogSink::kBoth:
-            sinks_.emplace_back(std::make_shared<internal::ConsoleSink>());
-            sinks_.emplace_back(std::make_shared<internal::FileSink>(config_.GetFilePath(), config_.GetMaxFileCount(),
-                                                                     config_.GetMaxFileSize()));
-            break;
-        default:
-            break;
+    internal::SinkRegistry& registry = internal::SinkRegistry::GetInstance();
+
+    // 参数改变的旧sink不能与新sink同时写入同一个文件：先撤下快照，等读取方离开后释放旧快照，
+    // 旧的异步写入器写完队列中的日志、旧sink关闭后再创建新sink。此期间记录日志的线程在config_mutex_上等待
+    if (state_owner_ != nullptr && registry.ReplacesSinks(state_owner_->config, config_)) {
+        state_.store(nullptr, std::memory_order_release);
+        epoch_->Synchronize();
+        state_owner_.reset();
+    }
+
+    // 其余情况在旧快照仍在使用时另行创建新快照，参数未变的输出目标和异步写入器从注册表取回同一个实例，
+    // 重新加载配置时不会关闭后再重新打开
+    auto state = std::make_unique<State>();
+    state->config = config_;
+    state->sinks = registry.AcquireSinks(config_);
+    if (config_.IsAsyncMode()) {
+        state->async_writer = registry.AcquireAsyncWriter(state->sinks, config_.GetAsyncQueueCapacity(),
+                                                          config_.GetOverflowPolicy());
     }
+    if (config_.GetRateLimit() > 0) {
+        uint32_t burst = config_.GetRateLimitBurst() != 0 ? config_.GetRateLimitBurst() : config_.GetRateLimit();
+        state->rate_interval_ns = std::max<int64_t>(1000000000 / static_cast<int64_t>(config_.GetRateLimit()), 1);
+        state->rate_tolerance_ns = state->rate_interval_ns * (static_cast<int64_t>(burst) - 1);
+    }
+    state->deduplicate = config_.IsDeduplicate();
+    internal::InitClockSource(config_.GetClockSource());
+    PublishState(std::move(state));
+}
+
+void Logger::PublishState(std::unique_ptr<State> state) {
+    state_.store(state.get(), std::memory_order_release);
+    std::unique_ptr<State> previous = std::move(state_owner_);
+    state_owner_ = std::move(state);
+    // 等待仍在使用旧快照的读取方离开，旧快照独占的异步写入器在释放时写完队列中的日志
+    epoch_->Synchronize();
 }
 
 void Logger::ReInitSinks() { InitSinks(); }
@@ -208,37 +647,36 @@ void Logger::ValidateConfig() {
 
 void Logger::StartConfigFileMonitor() {
     if (!config_file_path_.empty() && std::filesystem::exists(config_file_path_)) {
-        is_monitoring_ = true;
-        config_monitor_thread_ = std::thread(&Logger::MonitorConfigFile, this);
+        config_watch_id_ =
+            internal::ConfigWatcher::GetInstance().Watch(config_file_path_, [this] { ReloadConfigFile(); });
     }
 }
 
 void Logger::StopConfigFileMonitor() {
-    is_monitoring_ = false;
-    if (config_monitor_thread_.joinable()) {
-        config_monitor_thread_.join();
+    // 不等待下一次检查，只在重新加载正在进行时等待其完成
+    if (config_watch_id_ != 0) {
+        internal::ConfigWatcher::GetInstance().Unwatch(config_watch_id_);
+        config_watch_id_ = 0;
     }
 }
 
-void Logger::MonitorConfigFile() {
-    if (config_file_path_.empty()) {
-        return;
+void Logger::ReloadConfigFile() {
+    // 在锁外读取和解析配置文件；新配置以快照形式发布，日志记录线程不会因重新加载而阻塞
+    LogConfig config;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        config = config_;
     }
+    LoadConfigFromFile(config_file_path_, config);
 
-    time_t last_modified = internal::GetFileLastModifiedTime(config_file_path_);
-
-    while (is_monitoring_) {
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-
-        time_t current_modified = internal::GetFileLastModifiedTime(config_file_path_);
-        if (current_modified != last_modified) {
-            // 配置文件已修改，重新加载配置
-            std::lock_guard<std::mutex> lock(config_mutex_);
-            LoadConfigFromFile(config_file_path_);
-            ValidateConfig();
-            ReInitSinks();
-            last_modified = current_modified;
-        }
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    config_ = config;
+    ValidateConfig();
+    // 新快照发布后再修改级别，按新级别记录的日志不会写入旧的输出目标
+    ReInitSinks();
+    level_.store(config_.GetLogLevel(), std::memory_order_relaxed);
+    if (level_node_ != nullptr) {
+        internal::SetNodeLevel(*level_node_, config_.GetLogLevel());
     }
 }
 
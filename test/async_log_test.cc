@@ -0,0 +1,197 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tinylog/internal/async_writer.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::CountLines;
+
+constexpr int kThreadCount = 4;
+constexpr int kMessagesPerThread = 2000;
+
+// 日志文件写入临时目录，测试结束后删除
+const tinylog::test::TempDir kLogDir("tinylog_async_log_test");
+
+tinylog::LogConfig MakeAsyncConfig(const std::string& file_path, size_t capacity, tinylog::OverflowPolicy policy) {
+    tinylog::LogConfig config;
+    config.SetLogLevel(tinylog::LogLevel::kDebug);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(file_path);
+    config.SetMaxFileSize(1024 * 1024 * 64);  // 避免触发文件滚动
+    config.SetAsyncMode(true);
+    config.SetAsyncQueueCapacity(capacity);
+    config.SetOverflowPolicy(policy);
+    return config;
+}
+
+void WriteFromThreads(tinylog::Logger& logger) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&logger, t] {
+            for (int i = 0; i < kMessagesPerThread; ++i) {
+                logger.LogInfo("thread " + std::to_string(t) + " message " + std::to_string(i), __FILE__, __func__,
+                               __LINE__);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool TestOverflowPolicy(const char* name, tinylog::OverflowPolicy policy, size_t capacity) {
+    std::string file_path = kLogDir.File(std::string("async_") + name + ".log");
+
+    uint64_t dropped = 0;
+    {
+        tinylog::Logger logger(MakeAsyncConfig(file_path, capacity, policy));
+        WriteFromThreads(logger);
+        logger.Flush();
+        dropped = logger.GetDroppedCount();
+    }
+
+    size_t written = CountLines(file_path);
+    size_t total = kThreadCount * kMessagesPerThread;
+    bool passed = written + dropped == total;
+    if (policy == tinylog::OverflowPolicy::kBlock) {
+        passed = passed && dropped == 0;
+    }
+
+    if (passed) {
+        std::cout << "✓ Async " << name << " test passed (written=" << written << ", dropped=" << dropped << ")"
+                  << std::endl;
+    } else {
+        std::cout << "✗ Async " << name << " test failed (written=" << written << ", dropped=" << dropped << ")"
+                  << std::endl;
+    }
+    return passed;
+}
+
+bool TestFlushDrainsQueue() {
+    const std::string file_path = kLogDir.File("async_flush.log");
+
+    tinylog::Logger logger(MakeAsyncConfig(file_path, 1024, tinylog::OverflowPolicy::kBlock));
+    for (int i = 0; i < 100; ++i) {
+        logger.LogInfo("flush message " + std::to_string(i), __FILE__, __func__, __LINE__);
+    }
+    logger.Flush();
+
+    bool passed = CountLines(file_path) == 100;
+    std::cout << (passed ? "✓ Async flush test passed" : "✗ Async flush test failed") << std::endl;
+    return passed;
+}
+
+bool TestShortLivedThreads() {
+    const std::string file_path = kLogDir.File("async_short_lived.log");
+
+    constexpr int kRounds = 50;
+    constexpr int kMessagesPerRound = 10;
+    tinylog::Logger logger(MakeAsyncConfig(file_path, 64, tinylog::OverflowPolicy::kBlock));
+    for (int round = 0; round < kRounds; ++round) {
+        std::thread thread([&logger, round] {
+            for (int i = 0; i < kMessagesPerRound; ++i) {
+                logger.LogInfo("round " + std::to_string(round) + " message " + std::to_string(i), __FILE__, __func__,
+                               __LINE__);
+            }
+        });
+        thread.join();
+    }
+    logger.Flush();
+
+    bool passed = CountLines(file_path) == kRounds * kMessagesPerRound;
+    std::cout << (passed ? "✓ Async short-lived threads test passed" : "✗ Async short-lived threads test failed")
+              << std::endl;
+    return passed;
+}
+
+// 按到达顺序记录日志时间戳的sink，release之前第一条日志阻塞后台线程
+class OrderRecordingSink : public tinylog::internal::SinkInterface {
+public:
+    OrderRecordingSink() { setFormatter(nullptr); }
+
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> released{false};
+    std::vector<int64_t> timestamps;
+
+protected:
+    void write(std::string_view message, tinylog::LogLevel level) override {}
+
+    void writeEvent(const tinylog::internal::LogEvent& event) override {
+        blocked.store(true);
+        while (!released.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        timestamps.push_back(event.timestamp);
+    }
+};
+
+// 各通道积压的日志远多于一轮能处理的数量时，写出顺序仍按时间戳全局有序
+bool TestMergeOrder() {
+    // 后台线程阻塞期间生产者不能被通道容量阻塞，每个线程的积压不超过通道的最小容量
+    constexpr int kPerThread = 200;
+    auto sink = std::make_shared<OrderRecordingSink>();
+    tinylog::internal::AsyncWriter writer({sink}, 4096, tinylog::OverflowPolicy::kBlock);
+
+    auto make_event = [](int64_t timestamp) {
+        tinylog::internal::LogEvent event;
+        event.level = tinylog::LogLevel::kInfo;
+        event.timestamp = timestamp;
+        event.filename = __FILE__;
+        event.function = __func__;
+        return event;
+    };
+    writer.Enqueue(make_event(0));
+    while (!sink->blocked.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 两个线程的时间戳交错但疏密不同：一个是间隔为2的偶数，一个是间隔为20的奇数
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&writer, &make_event, t] {
+            for (int i = 1; i <= kPerThread; ++i) {
+                writer.Enqueue(make_event(t == 0 ? 2 * i : 20 * i + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    sink->released.store(true);
+    writer.Flush();
+
+    bool passed = sink->timestamps.size() == 2 * kPerThread + 1;
+    for (size_t i = 1; passed && i < sink->timestamps.size(); ++i) {
+        passed = sink->timestamps[i - 1] < sink->timestamps[i];
+    }
+    std::cout << (passed ? "✓ Async merge order test passed" : "✗ Async merge order test failed") << std::endl;
+    return passed;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog async tests..." << std::endl;
+
+    bool passed = true;
+    passed &= TestFlushDrainsQueue();
+    passed &= TestShortLivedThreads();
+    passed &= TestMergeOrder();
+    passed &= TestOverflowPolicy("block", tinylog::OverflowPolicy::kBlock, 16);
+    passed &= TestOverflowPolicy("drop_newest", tinylog::OverflowPolicy::kDropNewest, 16);
+    passed &= TestOverflowPolicy("drop_oldest", tinylog::OverflowPolicy::kDropOldest, 16);
+
+    std::cout << "All async tests completed!" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tinylog/internal/binary_log.h"
+#include "tinylog/internal/formatter.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+const std::string kLogDir = "./binary_log_test_logs";
+
+using tinylog::internal::BinaryLogEncoder;
+using tinylog::internal::BinaryLogReader;
+using tinylog::internal::FormatBuffer;
+using tinylog::internal::LogEvent;
+using tinylog::internal::TextFormatter;
+using tinylog::test::Report;
+
+std::string Format(const LogEvent& event) {
+    static const TextFormatter formatter(tinylog::TimestampPrecision::kMicroseconds);
+    FormatBuffer buffer;
+    formatter.format(event, buffer);
+    return std::string(buffer.view());
+}
+
+// 解码二进制数据，返回按文本格式化的所有日志
+std::vector<std::string> Decode(std::istream& input, std::string* error = nullptr) {
+    BinaryLogReader reader(input);
+    LogEvent event;
+    std::vector<std::string> lines;
+    while (reader.Next(event)) {
+        lines.push_back(Format(event));
+    }
+    if (error != nullptr) {
+        *error = reader.error();
+    }
+    return lines;
+}
+
+std::vector<std::string> DecodeFile(const std::string& path, std::string* error = nullptr) {
+    std::ifstream input(path, std::ios::binary);
+    return Decode(input, error);
+}
+
+// 编码后再解码的日志与原日志的文本格式完全一致：调用点、模块、乱序的时间戳、会话重新开始都能正确还原
+bool TestRoundTrip() {
+    static constexpr tinylog::internal::CallSite kSite = tinylog::internal::MakeCallSite<
+        tinylog::internal::ArgTypeList<int, const char*>>(tinylog::LogLevel::kWarn, "site.cc", "Handle", 12,
+                                                          "user {} from {}");
+    static const char* kModule = "net.http";
+
+    std::vector<LogEvent> events(5);
+    for (size_t i = 0; i < events.size(); ++i) {
+        LogEvent& event = events[i];
+        event.timestamp = 1700000000123456000 + static_cast<int64_t>(i % 2 == 0 ? i * 1000 : -1000);
+        event.level = tinylog::LogLevel::kInfo;
+        event.filename = "plain.cc";
+        event.function = "Run";
+        event.line = 7;
+        if (i % 2 == 0) {
+            event.site = &kSite;
+            event.level = kSite.level;
+            tinylog::internal::EncodeArgs(event.args, static_cast<int>(i), "host", tinylog::kv("ok", i == 2));
+        } else {
+            event.message = "plain message " + std::to_string(i);
+            event.module = std::string_view(kModule);
+        }
+    }
+
+    BinaryLogEncoder encoder;
+    FormatBuffer encoded;
+    encoder.BeginSession(true, encoded);
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (i == 3) {
+            encoder.BeginSession(false, encoded);
+        }
+        encoder.Encode(events[i], encoded);
+    }
+
+    std::istringstream input(std::string(encoded.view()));
+    std::string error;
+    std::vector<std::string> decoded = Decode(input, &error);
+    bool passed = error.empty() && decoded.size() == events.size();
+    for (size_t i = 0; passed && i < events.size(); ++i) {
+        passed = decoded[i] == Format(events[i]);
+        if (!passed) {
+            std::cout << "  expected: " << Format(events[i]) << "  decoded:  " << decoded[i];
+        }
+    }
+
+    // 截断的数据报告错误而不是输出错误的日志
+    std::istringstream truncated(std::string(encoded.view().substr(0, encoded.size() - 3)));
+    std::vector<std::string> partial = Decode(truncated, &error);
+    passed &= partial.size() == events.size() - 1 && !error.empty();
+    return Report("Round trip", passed);
+}
+
+// 二进制sink写入的文件解码后与日志一一对应，滚动后的每个文件都能独立解码，体积远小于文本格式
+bool TestBinarySink() {
+    constexpr int kCount = 2000;
+    std::string binary_path = kLogDir + "/app.bin";
+    std::string text_path = kLogDir + "/app.log";
+
+    auto make_config = [](const std::string& path, tinylog::LogLayout layout) {
+        tinylog::LogConfig config(tinylog::LogLevel::kDebug, tinylog::LogSink::kFile, path, 10, 16 * 1024, false);
+        config.SetLogLayout(layout);
+        return config;
+    };
+    {
+        tinylog::Logger binary_logger(make_config(binary_path, tinylog::LogLayout::kBinary));
+        tinylog::Logger text_logger(make_config(text_path, tinylog::LogLayout::kText));
+        for (int i = 0; i < kCount; ++i) {
+            binary_logger.Info("user {} took {} ms", i, i * 3, tinylog::kv("status", 200));
+            text_logger.Info("user {} took {} ms", i, i * 3, tinylog::kv("status", 200));
+        }
+        binary_logger.LogError("plain error", __FILE__, __FUNCTION__, __LINE__);
+    }
+
+    // 从最旧的备份到当前文件依次解码
+    std::vector<std::string> files;
+    for (int i = 10; i >= 1; --i) {
+        std::string backup = binary_path + "." + std::to_string(i);
+        if (std::filesystem::exists(backup)) {
+            files.push_back(backup);
+        }
+    }
+    files.push_back(binary_path);
+
+    std::vector<std::string> lines;
+    bool decoded_ok = files.size() > 1;
+    uintmax_t binary_size = 0;
+    for (const auto& file : files) {
+        std::string error;
+        std::vector<std::string> file_lines = DecodeFile(file, &error);
+        decoded_ok &= error.empty() && !file_lines.empty();
+        lines.insert(lines.end(), file_lines.begin(), file_lines.end());
+        binary_size += std::filesystem::file_size(file);
+    }
+
+    uintmax_t text_size = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(kLogDir)) {
+        if (entry.path().filename().string().rfind("app.log", 0) == 0) {
+            text_size += entry.file_size();
+        }
+    }
+
+    bool passed = decoded_ok && lines.size() == kCount + 1 &&
+                  lines.front().find(" - user 0 took 0 ms status=200\n") != std::string::npos &&
+                  lines[kCount - 1].find(" - user 1999 took 5997 ms status=200\n") != std::string::npos &&
+                  lines.back().find("[ERROR] ") != std::string::npos &&
+                  lines.back().find(" - plain error\n") != std::string::npos && binary_size * 2 < text_size;
+    std::cout << "  " << files.size() << " files, binary " << binary_size << " bytes, text " << text_size
+              << " bytes" << std::endl;
+    return Report("Binary sink", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog binary log tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestRoundTrip();
+    passed &= TestBinarySink();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All binary log tests passed!" : "Some binary log tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
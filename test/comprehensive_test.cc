@@ -62,9 +62,6 @@ void TestConfigFile() {
     // 测试日志输出
     logger.LogInfo("Logging with config file settings", __FILE__, __func__, __LINE__);
 
-    // 模拟配置文件更新
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-
     // 更新配置文件
     std::ofstream config_file_update("test_config.ini");
     config_file_update << "# Updated test log configuration\n";
@@ -77,7 +74,9 @@ void TestConfigFile() {
     config_file_update.close();
 
     // 等待配置文件监控线程检测到更新
-    std::this_thread::sleep_for(std::chrono::seconds(10));
+    for (int i = 0; i < 100 && logger.GetLogLevel() != tinylog::LogLevel::kInfo; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
 
     // 测试更新后的配置
     logger.LogDebug("This debug message should not appear (level changed to info)", __FILE__, __func__, __LINE__);
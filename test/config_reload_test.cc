@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./config_reload_test_logs";
+
+void WriteConfig(const std::string& path, const std::string& level, const std::string& log_path) {
+    std::ofstream file(path);
+    file << "log_level=" << level << "\n";
+    file << "log_sink=file\n";
+    file << "file_path=" << log_path << "\n";
+    file << "file_buffer_size=65536\n";
+    file << "flush_interval_ms=0\n";
+    file << "flush_level=fatal\n";
+}
+
+// 等待条件成立，返回等待的时间，超时返回负数
+int64_t WaitFor(const std::function<bool()>& condition) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2000; ++i) {
+        if (condition()) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return -1;
+}
+
+// 配置文件写入后很快重新加载，只修改级别时文件sink保持打开（缓冲区中的日志没有因重建sink而落盘）
+bool TestReloadKeepsSinks() {
+    std::string config_path = kLogDir + "/keep.ini";
+    std::string log_path = kLogDir + "/keep.log";
+    WriteConfig(config_path, "info", log_path);
+
+    tinylog::Logger logger(config_path);
+    logger.LogInfo("buffered before reload", __FILE__, __FUNCTION__, __LINE__);
+
+    WriteConfig(config_path, "error", log_path);
+    int64_t latency = WaitFor([&logger] { return logger.GetLogLevel() == tinylog::LogLevel::kError; });
+    bool kept_open = ReadFile(log_path).find("buffered before reload") == std::string::npos;
+
+    logger.Flush();
+    bool flushed = ReadFile(log_path).find("buffered before reload") != std::string::npos;
+    bool passed = latency >= 0 && latency < 1000 && kept_open && flushed;
+    std::cout << "  reload latency " << latency << " ms" << std::endl;
+    return Report("Reload keeps sinks", passed);
+}
+
+// 编辑器常用的写临时文件再rename的保存方式同样会触发重新加载，修改输出路径后写入新文件
+bool TestReloadOnRename() {
+    std::string config_path = kLogDir + "/rename.ini";
+    std::string first_log = kLogDir + "/rename_first.log";
+    std::string second_log = kLogDir + "/rename_second.log";
+    WriteConfig(config_path, "info", first_log);
+
+    tinylog::Logger logger(config_path);
+    logger.LogInfo("to first", __FILE__, __FUNCTION__, __LINE__);
+
+    std::string temp_path = config_path + ".tmp";
+    WriteConfig(temp_path, "debug", second_log);
+    std::rename(temp_path.c_str(), config_path.c_str());
+    int64_t latency = WaitFor([&logger] { return logger.GetLogLevel() == tinylog::LogLevel::kDebug; });
+
+    logger.LogDebug("to second", __FILE__, __FUNCTION__, __LINE__);
+    logger.Flush();
+    bool passed = latency >= 0 && ReadFile(first_log).find("to first") != std::string::npos &&
+                  ReadFile(second_log).find("to second") != std::string::npos;
+    return Report("Reload on rename", passed);
+}
+
+// 移动后由新对象接收配置文件的变化
+bool TestReloadAfterMove() {
+    std::string config_path = kLogDir + "/move.ini";
+    WriteConfig(config_path, "info", kLogDir + "/move.log");
+
+    tinylog::Logger original(config_path);
+    tinylog::Logger moved(std::move(original));
+    tinylog::Logger assigned(tinylog::LogConfig{});
+    assigned = std::move(moved);
+
+    WriteConfig(config_path, "warn", kLogDir + "/move.log");
+    int64_t latency = WaitFor([&assigned] { return assigned.GetLogLevel() == tinylog::LogLevel::kWarn; });
+    return Report("Reload after move", latency >= 0);
+}
+
+// 销毁通过配置文件创建的日志实例时不需要等待监控线程
+bool TestFastShutdown() {
+    std::string config_path = kLogDir + "/shutdown.ini";
+    WriteConfig(config_path, "info", kLogDir + "/shutdown.log");
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 20; ++i) {
+        tinylog::Logger logger(config_path);
+    }
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    return Report("Fast shutdown", elapsed < 1000);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog config reload tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestReloadKeepsSinks();
+    passed &= TestReloadOnRename();
+    passed &= TestReloadAfterMove();
+    passed &= TestFastShutdown();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All config reload tests passed!" : "Some config reload tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
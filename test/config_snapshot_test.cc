@@ -0,0 +1,98 @@
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::CountLines;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./config_snapshot_test_logs";
+
+tinylog::LogConfig MakeConfig(const std::string& path, bool async_mode, size_t buffer_size) {
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 256 * 1024 * 1024,
+                              async_mode);
+    config.SetOverflowPolicy(tinylog::OverflowPolicy::kBlock);
+    config.SetFileBufferSize(buffer_size);
+    return config;
+}
+
+// 多个线程持续记录日志，同时反复替换配置：切换同步和异步模式时新快照在旧快照仍被使用时创建，
+// 修改缓冲区大小时同一文件的sink被替换。两种替换都不能丢失或截断日志
+bool TestSwapUnderLoad() {
+    constexpr int kThreads = 4;
+    constexpr int kSwaps = 40;
+    constexpr size_t kMaxPerThread = 20000;
+    std::string path = kLogDir + "/swap.log";
+
+    tinylog::Logger logger(MakeConfig(path, false, 4096));
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> logged{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&logger, &stop, &logged, t] {
+            size_t count = 0;
+            while (!stop.load() && count < kMaxPerThread) {
+                logger.Info("thread {} record {}", t, count++);
+            }
+            logged.fetch_add(count);
+        });
+    }
+
+    for (int swap = 0; swap < kSwaps; ++swap) {
+        bool async_mode = swap % 2 == 0;
+        size_t buffer_size = swap % 4 < 2 ? 4096 : 8192;
+        logger.SetConfig(MakeConfig(path, async_mode, buffer_size));
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.Flush();
+
+    size_t lines = CountLines(path);
+    std::cout << "  " << kSwaps << " swaps, " << lines << " lines" << std::endl;
+    bool passed = lines == logged.load() && logger.GetDroppedCount() == 0;
+    return Report("Swap under load", passed);
+}
+
+// 只修改级别时快照在旧sink上重建，日志文件不被重新打开
+bool TestSwapKeepsSink() {
+    std::string path = kLogDir + "/keep.log";
+    tinylog::Logger logger(MakeConfig(path, false, 65536));
+    logger.Info("buffered {}", 1);
+
+    tinylog::LogConfig config = MakeConfig(path, false, 65536);
+    config.SetLogLevel(tinylog::LogLevel::kWarn);
+    logger.SetConfig(config);
+    bool kept_open = CountLines(path) == 0;
+
+    logger.Flush();
+    return Report("Swap keeps sink", kept_open && CountLines(path) == 1);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog config snapshot tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestSwapUnderLoad();
+    passed &= TestSwapKeepsSink();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All config snapshot tests passed!" : "Some config snapshot tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
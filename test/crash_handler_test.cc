@@ -0,0 +1,233 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tinylog/internal/async_writer.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/log_manager.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./crash_handler_test_logs";
+
+// 检测工具会接管重新触发的致命信号并以自己的方式终止进程，此时只检查进程异常终止
+#if defined(__SANITIZE_THREAD__) || defined(__SANITIZE_ADDRESS__)
+constexpr bool kSanitized = true;
+#else
+constexpr bool kSanitized = false;
+#endif
+
+size_t CountOccurrences(const std::string& content, const std::string& text) {
+    size_t count = 0;
+    for (size_t pos = content.find(text); pos != std::string::npos; pos = content.find(text, pos + text.size())) {
+        ++count;
+    }
+    return count;
+}
+
+// 在子进程中执行body，返回终止子进程的信号，正常退出时返回0（检测工具终止进程时返回-1）。子进程的标准错误输出被丢弃
+int RunInChild(const std::function<void()>& body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDERR_FILENO);
+        body();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status)) {
+        return WTERMSIG(status);
+    }
+    return WEXITSTATUS(status) == 0 || !kSanitized ? 0 : -1;
+}
+
+tinylog::LogConfig BufferedConfig(const std::string& path, bool async_mode) {
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 64 * 1024 * 1024,
+                              async_mode);
+    config.SetFileBufferSize(1024 * 1024);
+    config.SetFlushIntervalMs(0);
+    config.SetFlushLevel(tinylog::LogLevel::kFatal);
+    return config;
+}
+
+// 第一条日志阻塞后台线程的sink，之后入队的日志都留在队列中
+class BlockingSink : public tinylog::internal::SinkInterface {
+public:
+    explicit BlockingSink(int fd) : fd_(fd) {}
+
+    int crashFlush() noexcept override { return fd_; }
+
+    std::atomic<bool> blocked{false};
+
+protected:
+    void write(std::string_view message, tinylog::LogLevel level) override {
+        blocked.store(true);
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+
+private:
+    int fd_;
+};
+
+// 崩溃时文件缓冲区中尚未写出的日志被写入文件，随后是调用栈，进程仍因原信号终止
+bool TestSignalFlushesBuffer() {
+    std::string path = kLogDir + "/buffer.log";
+    int sig = RunInChild([&path] {
+        tinylog::LogManager::GetInstance().InstallCrashHandler();
+        tinylog::Logger logger(BufferedConfig(path, false));
+        for (int i = 0; i < 100; ++i) {
+            logger.Info("buffered record {}", i);
+        }
+        // 缓冲区足够大且不按时间刷新，崩溃前文件中还没有日志
+        if (std::filesystem::file_size(path) != 0) {
+            _exit(1);
+        }
+        raise(SIGSEGV);
+    });
+
+    std::string content = ReadFile(path);
+    size_t trace = content.find("*** tinylog: received signal 11 (SIGSEGV), stack trace: ***\n");
+    bool passed = (sig == SIGSEGV || (kSanitized && sig != 0)) &&
+                  CountOccurrences(content, " - buffered record ") == 100 &&
+                  content.find(" - buffered record 99\n") < trace && trace != std::string::npos &&
+                  content.find("[0x", trace) != std::string::npos;
+    return Report("Signal flushes file buffer", passed);
+}
+
+// 崩溃时异步队列中的日志被取出、格式化后直接写入sink的文件描述符
+bool TestSignalDrainsQueue() {
+    std::string path = kLogDir + "/queue.log";
+    int sig = RunInChild([&path] {
+        tinylog::LogManager::GetInstance().InstallCrashHandler();
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        auto sink = std::make_shared<BlockingSink>(fd);
+        tinylog::internal::AsyncWriter writer({sink}, 1024, tinylog::OverflowPolicy::kBlock);
+
+        auto make_event = [](const std::string& message) {
+            tinylog::internal::LogEvent event;
+            event.message = message;
+            event.level = tinylog::LogLevel::kWarn;
+            event.timestamp = 1700000000000000000;
+            event.filename = "queue.cc";
+            event.function = "Run";
+            event.line = 1;
+            return event;
+        };
+        writer.Enqueue(make_event("gate"));
+        while (!sink->blocked.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (int i = 0; i < 50; ++i) {
+            writer.Enqueue(make_event("queued record " + std::to_string(i)));
+        }
+        tinylog::internal::LogEvent no_location = make_event("no location");
+        no_location.filename = nullptr;
+        no_location.function = nullptr;
+        writer.Enqueue(std::move(no_location));
+        raise(SIGBUS);
+    });
+
+    std::string content = ReadFile(path);
+    size_t trace = content.find("received signal 7 (SIGBUS)");
+    bool passed = (sig == SIGBUS || (kSanitized && sig != 0)) &&
+                  CountOccurrences(content, "[WARN] queue.cc:Run:1 - queued record ") == 50 &&
+                  content.find(" - queued record 49\n") < trace && trace != std::string::npos &&
+                  content.find("[1700000000.000000000] [WARN] (null):(null):1 - no location\n") < trace &&
+                  content.find(" - gate") == std::string::npos;
+    return Report("Signal drains async queue", passed);
+}
+
+// 安装崩溃处理后kFatal日志写出全部日志和调用栈后终止进程
+bool TestFatalAborts() {
+    std::string path = kLogDir + "/fatal.log";
+    int sig = RunInChild([&path] {
+        tinylog::LogManager::GetInstance().InstallCrashHandler();
+        tinylog::Logger logger(BufferedConfig(path, true));
+        for (int i = 0; i < 1000; ++i) {
+            logger.Info("async record {}", i);
+        }
+        TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kFatal, "unrecoverable state");
+    });
+
+    std::string content = ReadFile(path);
+    size_t fatal = content.find("[FATAL]");
+    size_t trace = content.find("*** tinylog: fatal log record, stack trace: ***\n");
+    bool passed = sig == SIGABRT && CountOccurrences(content, " - async record ") == 1000 &&
+                  fatal != std::string::npos && content.find(" - unrecoverable state\n", fatal) != std::string::npos &&
+                  trace != std::string::npos && fatal < trace;
+    return Report("Fatal aborts", passed);
+}
+
+// 安装崩溃处理后，其他线程记录日志时获得自己的备用栈
+bool TestThreadAltStack() {
+    std::string path = kLogDir + "/alt_stack.log";
+    int sig = RunInChild([&path] {
+        tinylog::LogManager::GetInstance().InstallCrashHandler();
+        tinylog::Logger logger(BufferedConfig(path, false));
+        bool installed = false;
+        std::thread thread([&] {
+            stack_t before;
+            sigaltstack(nullptr, &before);
+            logger.Info("from thread {}", 1);
+            stack_t after;
+            sigaltstack(nullptr, &after);
+            installed = (before.ss_flags & SS_DISABLE) != 0 && (after.ss_flags & SS_DISABLE) == 0;
+        });
+        thread.join();
+        _exit(installed ? 0 : 1);
+    });
+    return Report("Thread alternate stack", sig == 0);
+}
+
+// 未安装崩溃处理时kFatal日志照常返回
+bool TestFatalWithoutHandler() {
+    std::string path = kLogDir + "/no_handler.log";
+    int sig = RunInChild([&path] {
+        tinylog::Logger logger(BufferedConfig(path, false));
+        logger.Fatal("fatal {}", 1);
+    });
+    bool passed = sig == 0 && ReadFile(path).find(" - fatal 1\n") != std::string::npos;
+    return Report("Fatal without handler", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog crash handler tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestSignalFlushesBuffer();
+    passed &= TestSignalDrainsQueue();
+    passed &= TestFatalAborts();
+    passed &= TestThreadAltStack();
+    passed &= TestFatalWithoutHandler();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All crash handler tests passed!" : "Some crash handler tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
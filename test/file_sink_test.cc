@@ -0,0 +1,469 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tinylog/internal/file_rotation.h"
+#include "tinylog/internal/maintenance.h"
+#include "tinylog/log_manager.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./file_sink_test_logs";
+
+tinylog::LogConfig MakeConfig(const std::string& path, size_t buffer_size, int64_t interval_ms) {
+    tinylog::LogConfig config(tinylog::LogLevel::kDebug, tinylog::LogSink::kFile, path, 3, 1024 * 1024, false);
+    config.SetFileBufferSize(buffer_size);
+    config.SetFlushIntervalMs(interval_ms);
+    config.SetFlushLevel(tinylog::LogLevel::kError);
+    return config;
+}
+
+// 缓冲区未满时日志只写入用户态缓冲区，显式刷新后才落盘
+bool TestBufferedUntilFlush() {
+    std::string path = kLogDir + "/buffered.log";
+    tinylog::Logger logger(MakeConfig(path, 64 * 1024, 0));
+
+    logger.LogInfo("buffered message", __FILE__, __FUNCTION__, __LINE__);
+    bool buffered = ReadFile(path).find("buffered message") == std::string::npos;
+
+    logger.Flush();
+    bool flushed = ReadFile(path).find("buffered message") != std::string::npos;
+    return Report("Buffered until flush", buffered && flushed);
+}
+
+// 达到刷新级别的日志立即落盘，并带出缓冲区中之前的日志
+bool TestFlushOnLevel() {
+    std::string path = kLogDir + "/level.log";
+    tinylog::Logger logger(MakeConfig(path, 64 * 1024, 0));
+
+    logger.LogInfo("before error", __FILE__, __FUNCTION__, __LINE__);
+    logger.LogError("error message", __FILE__, __FUNCTION__, __LINE__);
+
+    std::string content = ReadFile(path);
+    bool passed = content.find("before error") != std::string::npos &&
+                  content.find("error message") != std::string::npos &&
+                  content.find("before error") < content.find("error message");
+    return Report("Flush on level", passed);
+}
+
+// 缓冲区写满时自动落盘，超过缓冲区大小的单条日志直接写入且不被截断
+bool TestFlushOnFullBuffer() {
+    std::string path = kLogDir + "/full.log";
+    tinylog::Logger logger(MakeConfig(path, 1024, 0));
+
+    for (int i = 0; i < 64; ++i) {
+        logger.LogInfo("filling buffer " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+    }
+    std::string large_message(4096, 'x');
+    logger.LogInfo(large_message, __FILE__, __FUNCTION__, __LINE__);
+
+    std::string content = ReadFile(path);
+    bool passed = content.find("filling buffer 0") != std::string::npos &&
+                  content.find(large_message) != std::string::npos;
+    return Report("Flush on full buffer", passed);
+}
+
+// 距上次刷新超过刷新间隔时落盘：应用空闲、没有新日志也不显式刷新时，由维护线程的定时任务写出
+bool TestFlushOnInterval() {
+    std::string path = kLogDir + "/interval.log";
+    tinylog::Logger logger(MakeConfig(path, 64 * 1024, 50));
+
+    logger.LogInfo("idle message", __FILE__, __FUNCTION__, __LINE__);
+    bool flushed = false;
+    for (int i = 0; i < 100 && !flushed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        flushed = ReadFile(path).find("idle message") != std::string::npos;
+    }
+    return Report("Flush on interval", flushed);
+}
+
+// 按计数的文件大小触发滚动，滚动时不会因重复加锁而死锁
+bool TestRotation() {
+    std::string path = kLogDir + "/rotate.log";
+    tinylog::LogConfig config = MakeConfig(path, 4096, 0);
+    config.SetMaxFileSize(2048);
+    {
+        tinylog::Logger logger(config);
+        for (int i = 0; i < 200; ++i) {
+            logger.LogInfo("rotation message " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+        }
+    }
+
+    bool passed = std::filesystem::exists(path) && std::filesystem::exists(path + ".1") &&
+                  ReadFile(path).find("rotation message 199") != std::string::npos;
+    return Report("Rotation", passed);
+}
+
+// 多次滚动后备份文件按新旧顺序排列，数量不超过上限，且不残留临时文件
+bool TestRotationCascade() {
+    std::string path = kLogDir + "/cascade.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetMaxFileSize(1024);
+    {
+        tinylog::Logger logger(config);
+        for (int round = 0; round < 10; ++round) {
+            std::string message = "round " + std::to_string(round) + " " + std::string(1100, 'r');
+            logger.LogInfo(message, __FILE__, __FUNCTION__, __LINE__);
+        }
+    }
+
+    bool passed = ReadFile(path + ".1").find("round 8 ") != std::string::npos &&
+                  ReadFile(path + ".2").find("round 7 ") != std::string::npos &&
+                  ReadFile(path + ".3").find("round 6 ") != std::string::npos &&
+                  !std::filesystem::exists(path + ".4");
+    for (const auto& entry : std::filesystem::directory_iterator(kLogDir)) {
+        if (entry.path().filename().string().find(".rotating.") != std::string::npos) {
+            passed = false;
+        }
+    }
+    return Report("Rotation cascade", passed);
+}
+
+// 滚动后的备份文件被压缩为gzip格式
+bool TestCompressedRotation() {
+    if (!tinylog::internal::IsCompressionSupported()) {
+        return Report("Compressed rotation (skipped, no zlib)", true);
+    }
+
+    std::string path = kLogDir + "/compress.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetMaxFileSize(1024);
+    config.SetCompress(true);
+    {
+        tinylog::Logger logger(config);
+        for (int round = 0; round < 3; ++round) {
+            logger.LogInfo("round " + std::to_string(round) + " " + std::string(1100, 'c'), __FILE__, __FUNCTION__,
+                           __LINE__);
+        }
+    }
+
+    std::string compressed = ReadFile(path + ".1.gz");
+    bool passed = compressed.size() > 2 && static_cast<unsigned char>(compressed[0]) == 0x1f &&
+                  static_cast<unsigned char>(compressed[1]) == 0x8b && compressed.size() < 1100 &&
+                  std::filesystem::exists(path + ".2.gz") && !std::filesystem::exists(path + ".1");
+    return Report("Compressed rotation", passed);
+}
+
+// 备份文件的总大小超过上限时删除最旧的备份
+bool TestTotalSizeRetention() {
+    std::string path = kLogDir + "/total.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetMaxFileSize(1024);
+    config.SetMaxFileCount(10);
+    config.SetMaxTotalSize(4096);
+    {
+        tinylog::Logger logger(config);
+        for (int round = 0; round < 10; ++round) {
+            logger.LogInfo("round " + std::to_string(round) + " " + std::string(1100, 't'), __FILE__, __FUNCTION__,
+                           __LINE__);
+        }
+    }
+
+    uintmax_t backup_size = 0;
+    int backup_count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(kLogDir)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("total.log.", 0) == 0) {
+            backup_size += entry.file_size();
+            ++backup_count;
+        }
+    }
+    bool passed = backup_count > 0 && backup_size <= 4096 && std::filesystem::exists(path + ".1") &&
+                  !std::filesystem::exists(path + ".5");
+    return Report("Total size retention", passed);
+}
+
+// 按时间滚动的时间段计算
+bool TestRotationPeriod() {
+    constexpr int64_t kTimestamp = 1700000000LL * 1000000000;  // 2023-11-14 22:13:20 UTC
+    auto hourly = tinylog::internal::GetRotationPeriod(tinylog::RotationMode::kHourly, kTimestamp);
+    auto daily = tinylog::internal::GetRotationPeriod(tinylog::RotationMode::kDaily, kTimestamp);
+
+    bool passed = hourly.label == "20231114-22" && hourly.end_ns == 1700002800LL * 1000000000 &&
+                  daily.label == "20231114" && daily.end_ns == 1700006400LL * 1000000000;
+    return Report("Rotation period", passed);
+}
+
+// 按天滚动时，属于之前时间段的已有文件在首次写入时滚动为带日期的备份
+bool TestTimeRotation() {
+    std::string path = kLogDir + "/daily.log";
+    {
+        std::ofstream file(path);
+        file << "old content" << std::endl;
+    }
+    auto old_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(48);
+    std::filesystem::last_write_time(path, old_time);
+
+    auto old_seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch() - std::chrono::hours(48));
+    std::string label =
+        tinylog::internal::GetRotationPeriod(tinylog::RotationMode::kDaily, old_seconds.count()).label;
+
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetRotationMode(tinylog::RotationMode::kDaily);
+    {
+        tinylog::Logger logger(config);
+        logger.LogInfo("new content", __FILE__, __FUNCTION__, __LINE__);
+    }
+
+    std::string backup = ReadFile(path + "." + label);
+    bool passed = backup.find("old content") != std::string::npos &&
+                  ReadFile(path).find("new content") != std::string::npos &&
+                  ReadFile(path).find("old content") == std::string::npos;
+    return Report("Time rotation", passed);
+}
+
+size_t CountLines(const std::string& content) { return std::count(content.begin(), content.end(), '\n'); }
+
+bool HasNullBytes(const std::string& content) { return content.find('\0') != std::string::npos; }
+
+// 内存映射写入：多线程并发追加，关闭后文件截断到实际长度
+bool TestMmapConcurrentWrites() {
+    std::string path = kLogDir + "/mmap.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetFileEngine(tinylog::FileEngine::kMmap);
+    config.SetMaxFileSize(16 * 1024 * 1024);
+
+    constexpr int kThreads = 4;
+    constexpr int kMessages = 1000;
+    {
+        tinylog::Logger logger(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < kMessages; ++i) {
+                    logger.LogInfo("thread " + std::to_string(t) + " message " + std::to_string(i), __FILE__,
+                                   __FUNCTION__, __LINE__);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::string content = ReadFile(path);
+    bool passed = CountLines(content) == kThreads * kMessages && !HasNullBytes(content) &&
+                  std::filesystem::file_size(path) == content.size();
+    return Report("Mmap concurrent writes", passed);
+}
+
+// 内存映射写入：分段写满后切换到新分段，旧分段截断后归档
+bool TestMmapRotation() {
+    std::string path = kLogDir + "/mmap_rotate.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetFileEngine(tinylog::FileEngine::kMmap);
+    config.SetMaxFileSize(8192);
+    config.SetMaxFileCount(100);
+
+    constexpr int kMessages = 500;
+    {
+        tinylog::Logger logger(config);
+        for (int i = 0; i < kMessages; ++i) {
+            logger.LogInfo("mmap rotation message " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+        }
+    }
+
+    size_t lines = 0;
+    bool clean = true;
+    for (const auto& entry : std::filesystem::directory_iterator(kLogDir)) {
+        if (entry.path().filename().string().rfind("mmap_rotate.log", 0) == 0) {
+            std::string content = ReadFile(entry.path().string());
+            lines += CountLines(content);
+            clean = clean && !HasNullBytes(content);
+        }
+    }
+    bool passed = clean && lines == kMessages && std::filesystem::exists(path + ".1");
+    return Report("Mmap rotation", passed);
+}
+
+// 内存映射写入：复用分段只等待其解除映射，维护线程忙于其他任务（如压缩）时写入线程不被阻塞
+bool TestMmapRotationNotBlockedByMaintenance() {
+    std::string path = kLogDir + "/mmap_busy.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetFileEngine(tinylog::FileEngine::kMmap);
+    config.SetMaxFileSize(4096);
+    config.SetMaxFileCount(100);
+
+    constexpr int kMessages = 1000;  // 约十次滚动，超过分段数量
+    auto& worker = tinylog::internal::MaintenanceWorker::GetInstance();
+    // 占用维护线程至多3秒，写入线程等待维护任务时测试超时失败而不是一直阻塞。
+    // 标记由任务共享持有，测试函数返回后任务仍可安全访问
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    auto busy = std::make_shared<std::atomic<bool>>(false);
+    worker.Post([release, busy] {
+        busy->store(true);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (!release->load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!busy->load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        tinylog::Logger logger(config);
+        for (int i = 0; i < kMessages; ++i) {
+            logger.LogInfo("mmap busy message " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        release->store(true);
+        if (elapsed > std::chrono::seconds(2)) {
+            return Report("Mmap rotation not blocked by maintenance", false);
+        }
+    }
+
+    size_t lines = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(kLogDir)) {
+        if (entry.path().filename().string().rfind("mmap_busy.log", 0) == 0) {
+            std::string content = ReadFile(entry.path().string());
+            lines += CountLines(content);
+        }
+    }
+    return Report("Mmap rotation not blocked by maintenance", lines == kMessages);
+}
+
+// 内存映射写入：重新打开已有文件时在原有内容之后继续追加
+bool TestMmapReopen() {
+    std::string path = kLogDir + "/mmap_reopen.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetFileEngine(tinylog::FileEngine::kMmap);
+    {
+        tinylog::Logger logger(config);
+        logger.LogInfo("first run", __FILE__, __FUNCTION__, __LINE__);
+    }
+    {
+        tinylog::Logger logger(config);
+        logger.LogInfo("second run", __FILE__, __FUNCTION__, __LINE__);
+    }
+
+    std::string content = ReadFile(path);
+    bool passed = CountLines(content) == 2 && content.find("first run") < content.find("second run") &&
+                  !HasNullBytes(content);
+    return Report("Mmap reopen", passed);
+}
+
+// 内存映射写入：映射失败期间的日志被丢弃并计入统计，恢复后的写入重新映射文件
+bool TestMmapRemapAfterFailure() {
+    std::string path = kLogDir + "/mmap_remap.log";
+    tinylog::LogConfig config = MakeConfig(path, 0, 0);
+    config.SetFileEngine(tinylog::FileEngine::kMmap);
+    config.SetMaxFileSize(64 * 1024);
+
+    // 文件大小上限小于预分配长度，映射失败；超出上限时的SIGXFSZ默认会终止进程
+    struct rlimit original;
+    getrlimit(RLIMIT_FSIZE, &original);
+    struct rlimit limited = original;
+    limited.rlim_cur = 4096;
+    auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limited);
+
+    uint64_t dropped = 0;
+    {
+        tinylog::Logger logger(config);
+        setrlimit(RLIMIT_FSIZE, &original);
+        logger.LogInfo("lost while unmapped", __FILE__, __FUNCTION__, __LINE__);
+        logger.LogInfo("lost before retry", __FILE__, __FUNCTION__, __LINE__);
+
+        // 重试间隔过后的写入重新映射文件
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        logger.LogInfo("written after remap", __FILE__, __FUNCTION__, __LINE__);
+
+        for (const auto& sink : tinylog::LogManager::GetInstance().GetStats().sinks) {
+            if (sink.destination.find("/mmap_remap.log") != std::string::npos) {
+                dropped = sink.dropped;
+            }
+        }
+    }
+    std::signal(SIGXFSZ, previous_handler);
+
+    std::string content = ReadFile(path);
+    bool passed = dropped == 2 && CountLines(content) == 1 &&
+                  content.find("written after remap") != std::string::npos && !HasNullBytes(content);
+    return Report("Mmap remap after failure", passed);
+}
+
+// io_uring写入：按偏移量提交的多块缓冲区按顺序落盘，未启用io_uring时退化为pwritev
+bool TestUringWrites() {
+    std::string path = kLogDir + "/uring.log";
+    {
+        std::ofstream file(path);
+        file << "existing line" << std::endl;
+    }
+
+    tinylog::LogConfig config = MakeConfig(path, 1024, 0);
+    config.SetFileEngine(tinylog::FileEngine::kIoUring);
+    constexpr int kMessages = 2000;
+    {
+        tinylog::Logger logger(config);
+        for (int i = 0; i < kMessages; ++i) {
+            logger.LogInfo("uring message " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+        }
+    }
+
+    std::string content = ReadFile(path);
+    bool ordered = content.rfind("existing line", 0) == 0;
+    size_t last_pos = 0;
+    for (int i = 0; i < kMessages && ordered; ++i) {
+        size_t pos = content.find("uring message " + std::to_string(i) + "\n", last_pos);
+        ordered = pos != std::string::npos;
+        last_pos = pos;
+    }
+    bool passed = ordered && CountLines(content) == kMessages + 1 && !HasNullBytes(content);
+    return Report("io_uring writes", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog file sink tests..." << std::endl;
+
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestBufferedUntilFlush();
+    passed &= TestFlushOnLevel();
+    passed &= TestFlushOnFullBuffer();
+    passed &= TestFlushOnInterval();
+    passed &= TestRotation();
+    passed &= TestRotationCascade();
+    passed &= TestCompressedRotation();
+    passed &= TestTotalSizeRetention();
+    passed &= TestRotationPeriod();
+    passed &= TestTimeRotation();
+    passed &= TestMmapConcurrentWrites();
+    passed &= TestMmapRotation();
+    passed &= TestMmapReopen();
+    passed &= TestMmapRotationNotBlockedByMaintenance();
+    passed &= TestMmapRemapAfterFailure();
+    passed &= TestUringWrites();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All file sink tests passed!" : "Some file sink tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/internal/formatter.h"
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+// 统计堆内存分配次数
+namespace {
+std::atomic<bool> g_counting{false};
+std::atomic<size_t> g_allocations{0};
+}  // namespace
+
+void* operator new(size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+constexpr int kWarmupRecords = 100;
+constexpr int kMeasuredRecords = 1000;
+
+bool Check(const std::string& name, bool condition) {
+    std::cout << (condition ? "✓ " : "✗ ") << name << " test " << (condition ? "passed" : "failed") << std::endl;
+    return condition;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog allocation tests..." << std::endl;
+
+    tinylog::test::TempDir log_dir("tinylog_format_alloc_test");
+    const std::string file_path = log_dir.File("format_alloc.log");
+
+    tinylog::LogConfig config;
+    config.SetLogLevel(tinylog::LogLevel::kInfo);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(file_path);
+    config.SetMaxFileSize(1024 * 1024 * 64);  // 避免触发文件滚动
+
+    // 远超过旧实现256字节上限的长消息
+    const std::string long_message(2000, 'x');
+    bool passed = true;
+    {
+        tinylog::Logger logger(config);
+
+        auto log_records = [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kInfo, long_message);
+                TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kWarn, "request {} took {} us from {}", i, 1.25, "peer");
+            }
+        };
+
+        log_records(kWarmupRecords);
+
+        g_allocations.store(0);
+        g_counting.store(true);
+        log_records(kMeasuredRecords);
+        g_counting.store(false);
+
+        size_t allocations = g_allocations.load();
+        std::cout << "  allocations in steady state: " << allocations << std::endl;
+        passed &= Check("Zero steady-state allocations", allocations == 0);
+        logger.Flush();
+    }
+
+    std::ifstream file(file_path);
+    std::string line;
+    size_t full_lines = 0;
+    while (std::getline(file, line)) {
+        if (line.size() > long_message.size() && line.compare(line.size() - long_message.size(), std::string::npos,
+                                                              long_message) == 0) {
+            ++full_lines;
+        }
+    }
+    passed &= Check("Long messages not truncated", full_lines == kWarmupRecords + kMeasuredRecords);
+
+    // 调用方传入空的文件名和函数名时输出(null)
+    tinylog::internal::LogEvent event;
+    event.message = "no location";
+    event.level = tinylog::LogLevel::kInfo;
+    event.timestamp = 0;
+    event.filename = nullptr;
+    event.function = nullptr;
+    event.line = 7;
+    tinylog::internal::FormatBuffer out;
+    tinylog::internal::TextFormatter().format(event, out);
+    bool text_ok = out.view().find("] (null):(null):7 - no location\n") != std::string_view::npos;
+    tinylog::internal::JsonFormatter().format(event, out);
+    bool json_ok = out.view().find("\"file\":\"(null)\",\"func\":\"(null)\",\"line\":7") != std::string_view::npos;
+    passed &= Check("Null location", text_ok && json_ok);
+
+    std::cout << "All allocation tests completed!" << std::endl;
+
+    return passed ? 0 : 1;
+}
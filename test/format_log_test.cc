@@ -0,0 +1,215 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/internal/sink_interface.h"
+#include "tinylog/log_format.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+
+// 日志文件写入临时目录，测试结束后删除
+const tinylog::test::TempDir kLogDir("tinylog_format_log_test");
+
+// 编译期格式字符串解析
+static_assert(tinylog::internal::ParseFormat("user {} took {} ms").placeholder_count == 2);
+static_assert(tinylog::internal::ParseFormat("user {} took {} ms").placeholder_pos[1] == 13);
+static_assert(tinylog::internal::ParseFormat("{{}} {}").has_escapes);
+static_assert(!tinylog::internal::ParseFormat("unbalanced { brace").valid);
+
+// 只有字符串字面量延迟格式化，无法判断生存期的字符指针和可修改的字符数组不能隐式转换为格式字符串
+static_assert(std::is_convertible_v<const char (&)[8], tinylog::FormatString>);
+static_assert(std::is_convertible_v<std::string, tinylog::FormatString>);
+static_assert(!std::is_convertible_v<const char*, tinylog::FormatString>);
+static_assert(!std::is_convertible_v<char (&)[8], tinylog::FormatString>);
+
+template <typename... Args>
+std::string Format(const char* fmt, const Args&... args) {
+    tinylog::internal::ArgBuffer buffer;
+    tinylog::internal::EncodeArgs(buffer, args...);
+    tinylog::internal::FormatBuffer out;
+    tinylog::internal::FormatArgs(fmt, buffer, out);
+    return std::string(out.view());
+}
+
+bool Check(const std::string& name, const std::string& actual, const std::string& expected) {
+    if (actual == expected) {
+        std::cout << "✓ " << name << " test passed" << std::endl;
+        return true;
+    }
+    std::cout << "✗ " << name << " test failed: expected \"" << expected << "\", got \"" << actual << "\""
+              << std::endl;
+    return false;
+}
+
+bool TestFormatArgs() {
+    bool passed = true;
+    passed &= Check("Integer args", Format("user {} took {} ms", 42, 17u), "user 42 took 17 ms");
+    passed &= Check("Mixed args", Format("{} {} {} {}", true, 'x', -3L, 2.5), "true x -3 2.5");
+    std::string name = "alice";
+    passed &= Check("String args", Format("hello {} from {}", name, "bob"), "hello alice from bob");
+    passed &= Check("Escaped braces", Format("{{}} {}", 1), "{} 1");
+    passed &= Check("Missing args", Format("{} and {}", 1), "1 and {}");
+    passed &= Check("Extra args", Format("only {}", 1, 2), "only 1");
+
+    std::string long_text(200, 'a');
+    passed &= Check("Heap spill", Format("{}{}", long_text, 7), long_text + "7");
+    return passed;
+}
+
+bool TestDeferredLogging(bool async_mode) {
+    const std::string file_path = kLogDir.File(async_mode ? "format_async.log" : "format_sync.log");
+
+    tinylog::LogConfig config;
+    config.SetLogLevel(tinylog::LogLevel::kInfo);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(file_path);
+    config.SetAsyncMode(async_mode);
+
+    {
+        tinylog::Logger logger(config);
+        std::string user = "carol";
+        logger.Info("user {} took {} ms", user, 12);
+        logger.Debug("filtered {}", 1);
+        logger.Error("code={}", -5);
+        logger.Flush();
+    }
+
+    std::string content = ReadFile(file_path);
+    bool passed = content.find("[INFO]") != std::string::npos &&
+                  content.find("- user carol took 12 ms") != std::string::npos &&
+                  content.find("- code=-5") != std::string::npos && content.find("filtered") == std::string::npos &&
+                  content.find("TestDeferredLogging") != std::string::npos;
+    std::cout << (passed ? "✓ " : "✗ ") << (async_mode ? "Async" : "Sync") << " deferred logging test "
+              << (passed ? "passed" : "failed") << std::endl;
+    return passed;
+}
+
+// 异步模式下非字面量的格式字符串在调用线程上格式化，调用返回后修改或释放不影响输出
+bool TestRuntimeFormat() {
+    const std::string file_path = kLogDir.File("format_runtime.log");
+
+    tinylog::LogConfig config;
+    config.SetLogLevel(tinylog::LogLevel::kInfo);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(file_path);
+    config.SetAsyncMode(true);
+
+    {
+        tinylog::Logger logger(config);
+        auto format = std::make_unique<std::string>("runtime {} of {}");
+        logger.Info(*format, 1, 2, tinylog::kv("k", 3));
+        format->assign("overwritten {} of {}");
+        format.reset();
+        logger.Info(std::string("temporary {}"), 'x');
+        logger.Flush();
+    }
+
+    std::string content = ReadFile(file_path);
+    bool passed = content.find("- runtime 1 of 2 k=3\n") != std::string::npos &&
+                  content.find("- temporary x\n") != std::string::npos &&
+                  content.find("overwritten") == std::string::npos;
+    return tinylog::test::Report("Runtime format string", passed);
+}
+
+bool TestCallSiteLogging() {
+    const std::string file_path = kLogDir.File("format_call_site.log");
+
+    tinylog::LogConfig config;
+    config.SetLogLevel(tinylog::LogLevel::kInfo);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(file_path);
+
+    {
+        tinylog::Logger logger(config);
+        TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kInfo, "request {} finished in {} us", 7, 1.5);
+        TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kWarn, "braces {{}} kept, value={}", 3);
+        TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kDebug, "filtered {}", 0);
+        TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kError, std::string("plain message {}"));
+        logger.Flush();
+    }
+
+    std::string content = ReadFile(file_path);
+    bool passed = content.find("TestCallSiteLogging") != std::string::npos &&
+                  content.find("- request 7 finished in 1.5 us") != std::string::npos &&
+                  content.find("- braces {} kept, value=3") != std::string::npos &&
+                  content.find("- plain message {}") != std::string::npos &&
+                  content.find("filtered") == std::string::npos;
+    std::cout << (passed ? "✓ Call site logging test passed" : "✗ Call site logging test failed") << std::endl;
+    return passed;
+}
+
+// 记录格式化次数的格式化器
+class CountingFormatter : public tinylog::internal::TextFormatter {
+public:
+    void format(const tinylog::internal::LogEvent& event, tinylog::internal::FormatBuffer& out) const override {
+        ++count;
+        TextFormatter::format(event, out);
+    }
+
+    mutable int count = 0;
+};
+
+// 把日志写入内存的sink
+class MemorySink : public tinylog::internal::SinkInterface {
+public:
+    std::string content;
+
+protected:
+    void write(std::string_view message, tinylog::LogLevel) override { content.append(message); }
+};
+
+bool TestFormatOnceFanOut() {
+    auto counting = std::make_shared<CountingFormatter>();
+    auto other = std::make_shared<tinylog::internal::TextFormatter>();
+    auto first = std::make_shared<MemorySink>();
+    auto second = std::make_shared<MemorySink>();
+    auto third = std::make_shared<MemorySink>();
+    first->setFormatter(counting);
+    second->setFormatter(counting);
+    third->setFormatter(other);
+    std::vector<std::shared_ptr<tinylog::internal::SinkInterface>> sinks{first, second, third};
+
+    tinylog::internal::LogEvent event;
+    event.message = "fan out";
+    event.level = tinylog::LogLevel::kInfo;
+    event.timestamp = 0;
+    event.filename = __FILE__;
+    event.function = __func__;
+    event.line = __LINE__;
+    tinylog::internal::SinkInterface::dispatch(event, sinks);
+    tinylog::internal::SinkInterface::dispatch(event, sinks);
+
+    bool passed = counting->count == 2 && first->content == second->content && first->content == third->content &&
+                  first->content.find("- fan out") != std::string::npos;
+    std::cout << (passed ? "✓ Format once fan out test passed" : "✗ Format once fan out test failed") << std::endl;
+    return passed;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog format tests..." << std::endl;
+
+    bool passed = true;
+    passed &= TestFormatArgs();
+    passed &= TestDeferredLogging(false);
+    passed &= TestDeferredLogging(true);
+    passed &= TestRuntimeFormat();
+    passed &= TestCallSiteLogging();
+    passed &= TestFormatOnceFanOut();
+
+    std::cout << "All format tests completed!" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+
+// 在本测试中把编译期最低级别设为INFO，验证DEBUG日志宏被完全移除
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_INFO
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+// 日志文件写入临时目录，测试结束后删除
+const tinylog::test::TempDir kLogDir("tinylog_level_filter_test");
+
+int g_message_builds = 0;
+
+std::string BuildMessage(const char* text) {
+    ++g_message_builds;
+    return text;
+}
+
+bool Check(const std::string& name, bool condition) {
+    std::cout << (condition ? "✓ " : "✗ ") << name << " test " << (condition ? "passed" : "failed") << std::endl;
+    return condition;
+}
+
+tinylog::LogConfig MakeFileConfig(tinylog::LogLevel level) {
+    tinylog::LogConfig config;
+    config.SetLogLevel(level);
+    config.SetLogSink(tinylog::LogSink::kFile);
+    config.SetFilePath(kLogDir.File("level_filter.log"));
+    return config;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog level filter tests..." << std::endl;
+
+    bool passed = true;
+
+    {
+        tinylog::Logger logger(MakeFileConfig(tinylog::LogLevel::kWarn));
+
+        // 运行时被过滤的日志不会对消息表达式求值
+        g_message_builds = 0;
+        TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kInfo, BuildMessage("filtered at runtime"));
+        passed &= Check("Runtime filter skips message", g_message_builds == 0);
+
+        TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kError, BuildMessage("enabled"));
+        passed &= Check("Enabled level builds message", g_message_builds == 1);
+
+        // 级别检查不需要加锁，修改后立即生效
+        logger.SetLogLevel(tinylog::LogLevel::kDebug);
+        passed &= Check("ShouldLog after SetLogLevel", logger.ShouldLog(tinylog::LogLevel::kDebug));
+
+        // 编译期被移除的级别即使运行时启用也不会求值
+        g_message_builds = 0;
+        TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kDebug, BuildMessage("stripped at compile time"));
+        passed &= Check("Compile-time strip skips message", g_message_builds == 0);
+
+        TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kDebug, "stripped {}", BuildMessage("arg"));
+        passed &= Check("Compile-time strip skips format args", g_message_builds == 0);
+    }
+
+    std::cout << "All level filter tests completed!" << std::endl;
+
+    return passed ? 0 : 1;
+}
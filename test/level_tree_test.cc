@@ -0,0 +1,104 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::Report;
+
+using tinylog::LogLevel;
+
+// 未设置级别的模块继承最近的已设置祖先
+bool TestInheritance() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    tinylog::Logger& client = manager.GetModuleLogger("net.http.client");
+    tinylog::Logger& server = manager.GetModuleLogger("net.http.server");
+    tinylog::Logger& db = manager.GetModuleLogger("db");
+
+    manager.SetModuleLogLevel("net", LogLevel::kWarn);
+    bool inherited = client.GetLogLevel() == LogLevel::kWarn && server.GetLogLevel() == LogLevel::kWarn &&
+                     manager.GetModuleLogLevel("net.http") == LogLevel::kWarn && db.GetLogLevel() == LogLevel::kInfo;
+
+    manager.SetModuleLogLevel("net.http.client", LogLevel::kDebug);
+    bool child_override = client.ShouldLog(LogLevel::kDebug) && !server.ShouldLog(LogLevel::kInfo);
+    return Report("Inheritance", inherited && child_override);
+}
+
+// 设置父模块级别时覆盖子模块此前的设置，设置全局级别时覆盖所有模块
+bool TestSubtreeOverride() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    tinylog::Logger& leaf = manager.GetModuleLogger("app.service.worker");
+    manager.SetModuleLogLevel("app.service.worker", LogLevel::kDebug);
+    manager.SetModuleLogLevel("app", LogLevel::kError);
+    bool subtree = leaf.GetLogLevel() == LogLevel::kError;
+
+    manager.SetModuleLogLevel("app.service.worker", LogLevel::kDebug);
+    bool reset_child = leaf.GetLogLevel() == LogLevel::kDebug;
+
+    manager.SetGlobalLogLevel(LogLevel::kWarn);
+    bool global = leaf.GetLogLevel() == LogLevel::kWarn &&
+                  manager.GetModuleLogger("net.http.client").GetLogLevel() == LogLevel::kWarn &&
+                  manager.GetGlobalLogger().GetLogLevel() == LogLevel::kWarn;
+    return Report("Subtree override", subtree && reset_child && global);
+}
+
+// 模块日志实例自身的级别设置等同于设置其级别节点
+bool TestLoggerSetLevel() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    tinylog::Logger& parent = manager.GetModuleLogger("storage");
+    tinylog::Logger& child = manager.GetModuleLogger("storage.cache");
+    parent.SetLogLevel(LogLevel::kFatal);
+    bool propagated = child.GetLogLevel() == LogLevel::kFatal;
+
+    tinylog::LogConfig config;
+    config.SetLogLevel(LogLevel::kDebug);
+    tinylog::Logger& configured = manager.GetModuleLogger("storage.cache.disk", config);
+    bool explicit_config = configured.GetLogLevel() == LogLevel::kDebug && child.GetLogLevel() == LogLevel::kFatal;
+    return Report("Logger set level", propagated && explicit_config);
+}
+
+// 其他线程修改级别后，正在记录日志的线程在后续调用中看到新级别
+bool TestConcurrentLevelChange() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    tinylog::Logger& logger = manager.GetModuleLogger("concurrent.level.module");
+    manager.SetModuleLogLevel("concurrent", LogLevel::kError);
+
+    std::atomic<bool> stop{false};
+    std::atomic<bool> saw_debug{false};
+    std::thread reader([&] {
+        while (!stop.load(std::memory_order_acquire)) {
+            if (logger.ShouldLog(LogLevel::kDebug)) {
+                saw_debug.store(true, std::memory_order_release);
+            }
+        }
+    });
+
+    manager.SetModuleLogLevel("concurrent.level", LogLevel::kDebug);
+    for (int i = 0; i < 1000000 && !saw_debug.load(std::memory_order_acquire); ++i) {
+        std::this_thread::yield();
+    }
+    stop.store(true, std::memory_order_release);
+    reader.join();
+    return Report("Concurrent level change", saw_debug.load() && logger.GetLogLevel() == LogLevel::kDebug);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog level tree tests..." << std::endl;
+
+    bool passed = true;
+    passed &= TestInheritance();
+    passed &= TestSubtreeOverride();
+    passed &= TestLoggerSetLevel();
+    passed &= TestConcurrentLevelChange();
+
+    std::cout << (passed ? "All level tree tests passed!" : "Some level tree tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
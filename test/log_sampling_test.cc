@@ -0,0 +1,123 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/log_manager.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadLines;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./log_sampling_test_logs";
+
+// 每个测试使用单独的模块日志和输出文件
+tinylog::Logger& ModuleLogger(const std::string& module) {
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, kLogDir + "/" + module + ".log", 3,
+                              64 * 1024 * 1024, false);
+    return tinylog::LogManager::GetInstance().GetModuleLogger(module, config);
+}
+
+std::vector<std::string> ModuleLines(const std::string& module) {
+    ModuleLogger(module).Flush();
+    return ReadLines(kLogDir + "/" + module + ".log");
+}
+
+// EVERY_N记录第1、n+1、2n+1...次调用，FIRST_N只记录前n次调用；未被采样的调用不进入日志实例，不计入过滤数量
+bool TestEveryNAndFirstN() {
+    ModuleLogger("sample.every");
+    ModuleLogger("sample.first");
+    ModuleLogger("sample.debug");
+    for (int i = 0; i < 1000; ++i) {
+        LOG_MODULE_EVERY_N("sample.every", INFO, 100, "item " + std::to_string(i));
+        LOGF_MODULE_FIRST_N("sample.first", WARN, 3, "slow item {}", i);
+        LOG_MODULE_EVERY_N("sample.debug", DEBUG, 100, "hidden");
+    }
+
+    std::vector<std::string> every = ModuleLines("sample.every");
+    std::vector<std::string> first = ModuleLines("sample.first");
+    tinylog::LoggerStats debug_stats = ModuleLogger("sample.debug").GetStats();
+    bool passed = every.size() == 10 && every[0].find(" - item 0") != std::string::npos &&
+                  every[9].find(" - item 900") != std::string::npos && first.size() == 3 &&
+                  first[2].find("[WARN]") != std::string::npos &&
+                  first[2].find(" - slow item 2") != std::string::npos && debug_stats.filtered == 10 &&
+                  debug_stats.accepted == 0;
+    return Report("Every N and first N", passed);
+}
+
+// 多个线程共享同一调用点的采样计数
+bool TestConcurrentSampling() {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 10000;
+    ModuleLogger("sample.concurrent");
+    ModuleLogger("sample.concurrent_first");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < kPerThread; ++i) {
+                LOGF_MODULE_EVERY_N("sample.concurrent", INFO, 64, "record {}", i);
+                LOG_MODULE_FIRST_N("sample.concurrent_first", INFO, 5, "first");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool passed = ModuleLines("sample.concurrent").size() == (kThreads * kPerThread + 63) / 64 &&
+                  ModuleLines("sample.concurrent_first").size() == 5;
+    return Report("Concurrent sampling", passed);
+}
+
+// EVERY_T记录首次调用，之后每隔至少一个间隔记录一次
+bool TestEveryT() {
+    ModuleLogger("sample.time");
+    ModuleLogger("sample.chrono");
+    auto start = std::chrono::steady_clock::now();
+    int iterations = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(350)) {
+        LOGF_MODULE_EVERY_T("sample.time", INFO, 0.1, "tick {}", iterations);
+        LOG_MODULE_EVERY_T("sample.chrono", INFO, std::chrono::hours(1), "once");
+        ++iterations;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::string> ticks = ModuleLines("sample.time");
+    bool passed = ticks.size() >= 2 && static_cast<double>(ticks.size()) <= 1 + elapsed / 0.1 &&
+                  ticks[0].find(" - tick 0") != std::string::npos && ModuleLines("sample.chrono").size() == 1;
+    std::cout << "  " << ticks.size() << " records in " << elapsed << " s over " << iterations << " calls"
+              << std::endl;
+    return Report("Every T", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog sampling tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestEveryNAndFirstN();
+    passed &= TestConcurrentSampling();
+    passed &= TestEveryT();
+
+    tinylog::LogManager::GetInstance().FlushAll();
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All sampling tests passed!" : "Some sampling tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
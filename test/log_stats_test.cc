@@ -0,0 +1,168 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/log_manager.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./log_stats_test_logs";
+
+const tinylog::SinkStats* FindSink(const tinylog::LogStats& stats, const std::string& file_name) {
+    for (const auto& sink : stats.sinks) {
+        if (sink.destination.size() >= file_name.size() &&
+            sink.destination.compare(sink.destination.size() - file_name.size(), file_name.size(), file_name) == 0) {
+            return &sink;
+        }
+    }
+    return nullptr;
+}
+
+const tinylog::LoggerStats* FindLogger(const tinylog::LogStats& stats, const std::string& module) {
+    for (const auto& logger : stats.loggers) {
+        if (logger.module == module) {
+            return &logger;
+        }
+    }
+    return nullptr;
+}
+
+// 多个线程记录的日志按级别分别计入接受和过滤数量，字节数与文件大小一致，写入次数和刷新耗时都有记录
+bool TestCounters() {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+    std::string path = kLogDir + "/counters.log";
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 64 * 1024 * 1024, false);
+    config.SetFileBufferSize(4096);
+    tinylog::Logger& logger = tinylog::LogManager::GetInstance().GetModuleLogger("stats.counters", config);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&logger, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kInfo, "record " + std::to_string(i));
+                TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kDebug, "hidden");
+                logger.Debug("hidden {}", t);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.Flush();
+
+    tinylog::LogStats stats = tinylog::LogManager::GetInstance().GetStats();
+    const tinylog::LoggerStats* logger_stats = FindLogger(stats, "stats.counters");
+    const tinylog::SinkStats* sink_stats = FindSink(stats, "/counters.log");
+    bool passed = logger_stats != nullptr && sink_stats != nullptr &&
+                  logger_stats->accepted == kThreads * kPerThread &&
+                  logger_stats->filtered == 2 * kThreads * kPerThread && logger_stats->dropped == 0 &&
+                  logger_stats->queue_capacity == 0 &&
+                  sink_stats->bytes_written == std::filesystem::file_size(path) &&
+                  sink_stats->write_calls >= sink_stats->bytes_written / 4096 && sink_stats->flushes > 0 &&
+                  sink_stats->rotations == 0 && sink_stats->FlushLatencyPercentileUs(0.5) > 0 &&
+                  sink_stats->FlushLatencyPercentileUs(0.5) <= sink_stats->FlushLatencyPercentileUs(1.0);
+    if (!passed) {
+        std::cout << stats.ToString();
+    }
+    return Report("Logger and sink counters", passed);
+}
+
+// 异步模式下丢弃的日志计入丢弃数量，队列的最大积压不超过通道容量；文件滚动计入滚动次数
+bool TestQueueAndRotation() {
+    constexpr int kCount = 20000;
+    std::string path = kLogDir + "/async.log";
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 64 * 1024, true);
+    config.SetAsyncQueueCapacity(64);
+    config.SetOverflowPolicy(tinylog::OverflowPolicy::kDropNewest);
+
+    tinylog::LoggerStats logger_stats;
+    {
+        tinylog::Logger logger(config);
+        for (int i = 0; i < kCount; ++i) {
+            logger.Info("async record {} with some padding to fill the file", i);
+        }
+        logger.Flush();
+        logger_stats = logger.GetStats();
+    }
+
+    // 日志实例销毁后sink随之关闭，从注册表中取不到，因此另建一个sink检查滚动次数
+    std::string rotate_path = kLogDir + "/rotate.log";
+    tinylog::LogConfig rotate_config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, rotate_path, 3, 4096, false);
+    tinylog::Logger rotate_logger(rotate_config);
+    for (int i = 0; i < 1000; ++i) {
+        rotate_logger.Info("rotating record {}", i);
+    }
+    rotate_logger.Flush();
+    const tinylog::SinkStats* sink_stats = nullptr;
+    tinylog::LogStats stats = tinylog::LogManager::GetInstance().GetStats();
+    sink_stats = FindSink(stats, "/rotate.log");
+
+    bool passed = logger_stats.accepted == kCount && logger_stats.queue_capacity == 64 &&
+                  logger_stats.queue_high_water > 0 && logger_stats.queue_high_water <= 64 &&
+                  logger_stats.dropped < kCount && sink_stats != nullptr && sink_stats->rotations > 0;
+    std::cout << "  dropped " << logger_stats.dropped << ", queue high water " << logger_stats.queue_high_water
+              << ", rotations " << (sink_stats != nullptr ? sink_stats->rotations : 0) << std::endl;
+    return Report("Queue and rotation", passed);
+}
+
+// 定期输出的统计写入统计模块的输出目标
+bool TestStatsDump() {
+    std::string path = kLogDir + "/stats.log";
+    tinylog::LogConfig config(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 1024 * 1024, false);
+    config.SetFlushLevel(tinylog::LogLevel::kInfo);
+    auto& manager = tinylog::LogManager::GetInstance();
+    manager.GetModuleLogger(tinylog::LogManager::kStatsModule, config);
+
+    manager.StartStatsDump(std::chrono::milliseconds(10));
+    std::string content;
+    for (int i = 0; i < 200; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        content = ReadFile(path);
+        if (content.find("logger=stats.counters accepted=20000 filtered=40000") != std::string::npos &&
+            content.find("sink=file:") != std::string::npos) {
+            break;
+        }
+    }
+    manager.StopStatsDump();
+
+    bool passed = content.find("logger=stats.counters accepted=20000 filtered=40000 dropped=0 suppressed=0\n") !=
+                      std::string::npos &&
+                  content.find("logger=global ") != std::string::npos &&
+                  content.find("/stats.log bytes=") != std::string::npos &&
+                  content.find(" flush_p99_us=") != std::string::npos;
+    return Report("Stats dump", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog stats tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestCounters();
+    passed &= TestQueueAndRotation();
+    passed &= TestStatsDump();
+
+    tinylog::LogManager::GetInstance().FlushAll();
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All stats tests passed!" : "Some stats tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
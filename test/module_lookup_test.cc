@@ -0,0 +1,103 @@
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::Report;
+
+// 不同类型的模块名查找到同一个日志实例
+bool TestSameLoggerForSameName() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    tinylog::Logger& from_literal = manager.GetModuleLogger("lookup");
+    tinylog::Logger& from_string = manager.GetModuleLogger(std::string("lookup"));
+    tinylog::Logger& from_view = manager.GetModuleLogger(std::string_view("lookup_suffix", 6));
+    tinylog::Logger& other = manager.GetModuleLogger("lookup_other");
+
+    bool passed = &from_literal == &from_string && &from_literal == &from_view && &from_literal != &other &&
+                  &manager.GetModuleEntry("lookup") == &manager.GetModuleEntry("lookup");
+    return Report("Same logger for same name", passed);
+}
+
+// 同一调用点使用运行时变化的模块名时，缓存不会返回上一个模块的日志实例
+bool TestCallSiteWithVaryingName() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    bool passed = true;
+    for (int round = 0; round < 3; ++round) {
+        for (const char* name : {"site_a", "site_b", "site_c"}) {
+            tinylog::Logger& cached = TINYLOG_MODULE_LOGGER(std::string(name));
+            passed &= &cached == &manager.GetModuleLogger(name);
+        }
+    }
+    return Report("Call site with varying name", passed);
+}
+
+// 多个线程并发创建和查找大量模块，触发注册表扩容
+bool TestConcurrentCreation() {
+    constexpr int kThreads = 4;
+    constexpr int kModules = 500;
+    auto& manager = tinylog::LogManager::GetInstance();
+
+    std::vector<std::vector<tinylog::Logger*>> results(kThreads, std::vector<tinylog::Logger*>(kModules));
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            // 各线程以不同顺序访问，使创建和查找交错进行
+            for (int i = 0; i < kModules; ++i) {
+                int index = (t % 2 == 0) ? i : kModules - 1 - i;
+                results[t][index] = &manager.GetModuleLogger("concurrent_" + std::to_string(index));
+            }
+        });
+    }
+    start.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool passed = true;
+    for (int i = 0; i < kModules; ++i) {
+        tinylog::Logger* expected = &manager.GetModuleLogger("concurrent_" + std::to_string(i));
+        for (int t = 0; t < kThreads; ++t) {
+            passed &= results[t][i] == expected;
+        }
+    }
+    return Report("Concurrent creation", passed);
+}
+
+// 模块级别设置作用于查找到的日志实例，模块尚未创建时同样生效
+bool TestModuleLogLevel() {
+    auto& manager = tinylog::LogManager::GetInstance();
+    manager.SetModuleLogLevel("level_module", tinylog::LogLevel::kError);
+    tinylog::Logger& logger = manager.GetModuleLogger("level_module");
+    bool set_before_creation = logger.GetLogLevel() == tinylog::LogLevel::kError;
+
+    manager.SetModuleLogLevel(std::string("level_module"), tinylog::LogLevel::kWarn);
+    bool updated = logger.GetLogLevel() == tinylog::LogLevel::kWarn;
+    return Report("Module log level", set_before_creation && updated);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog module lookup tests..." << std::endl;
+
+    bool passed = true;
+    passed &= TestSameLoggerForSameName();
+    passed &= TestCallSiteWithVaryingName();
+    passed &= TestConcurrentCreation();
+    passed &= TestModuleLogLevel();
+
+    std::cout << (passed ? "All module lookup tests passed!" : "Some module lookup tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
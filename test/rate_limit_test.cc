@@ -0,0 +1,172 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadLines;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./rate_limit_test_logs";
+
+size_t CountContaining(const std::vector<std::string>& lines, const std::string& text) {
+    size_t count = 0;
+    for (const auto& line : lines) {
+        count += line.find(text) != std::string::npos ? 1 : 0;
+    }
+    return count;
+}
+
+tinylog::LogConfig MakeConfig(const std::string& path) {
+    return tinylog::LogConfig(tinylog::LogLevel::kInfo, tinylog::LogSink::kFile, path, 3, 64 * 1024 * 1024, false);
+}
+
+// 每个调用点独立限流：突发数量之后的日志被丢弃，下一条放行的日志之前报告丢弃数量
+bool TestRateLimit() {
+    constexpr int kCount = 10000;
+    std::string path = kLogDir + "/rate.log";
+    tinylog::LogConfig config = MakeConfig(path);
+    config.SetRateLimit(1, 5);
+
+    tinylog::LoggerStats stats;
+    {
+        tinylog::Logger logger(config);
+        auto log_request = [&logger](int i) {
+            TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kError, "request {} failed", i);
+        };
+        for (int i = 0; i < kCount; ++i) {
+            TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kError, "dependency down");
+            log_request(i);
+            logger.Error("retry {} failed", i);
+        }
+        // 等待一个令牌后同一调用点再次放行，先输出丢弃数量；之后再没有日志经过的调用点在析构时补报
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        for (int i = 0; i < 2; ++i) {
+            log_request(kCount + i);
+        }
+        stats = logger.GetStats();
+    }
+
+    std::vector<std::string> lines = ReadLines(path);
+    bool passed = CountContaining(lines, "dependency down") == 5 && CountContaining(lines, "failed") == 11 &&
+                  CountContaining(lines, "retry ") == 5 &&
+                  CountContaining(lines, " - 9995 messages suppressed by rate limit") == 3 &&
+                  lines.size() == 20 && lines[15].find("9995 messages suppressed") != std::string::npos &&
+                  lines[16].find("request 10000 failed") != std::string::npos &&
+                  lines[17].find("dependency down") == std::string::npos &&
+                  lines[18].find(" - 1 messages suppressed by rate limit") != std::string::npos &&
+                  stats.accepted == 16 &&
+                  stats.suppressed == 3 * kCount + 2 - 16;
+    if (!passed) {
+        std::cout << "  " << lines.size() << " lines, accepted " << stats.accepted << ", suppressed "
+                  << stats.suppressed << std::endl;
+    }
+    return Report("Rate limit", passed);
+}
+
+// 同一调用点连续相同的日志只输出一次，内容变化时先报告重复次数；参数不同的格式化日志不算重复
+bool TestDeduplicate() {
+    std::string path = kLogDir + "/dedup.log";
+    tinylog::LogConfig config = MakeConfig(path);
+    config.SetDeduplicate(true);
+    {
+        tinylog::Logger logger(config);
+        for (int round = 0; round < 2; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                TINYLOG_LOG_SITE(logger, tinylog::LogLevel::kWarn, round == 0 ? "disk full" : "disk ok");
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kWarn, "queue length {}", i);
+        }
+        // 不经调用点描述符的格式化日志同样按参数区分内容
+        for (int i = 0; i < 6; ++i) {
+            logger.Warn("retry {}", i / 2);
+        }
+        for (int i = 0; i < 2; ++i) {
+            logger.Warn(std::string("runtime {}"), i);
+        }
+    }
+
+    std::vector<std::string> lines = ReadLines(path);
+    bool passed = lines.size() == 15 && lines[0].find(" - disk full") != std::string::npos &&
+                  lines[1].find(" - last message repeated 999 times") != std::string::npos &&
+                  lines[1].find("[WARN]") != std::string::npos && lines[2].find(" - disk ok") != std::string::npos &&
+                  lines[3].find(" - queue length 0") != std::string::npos &&
+                  lines[5].find(" - queue length 2") != std::string::npos &&
+                  lines[6].find(" - retry 0") != std::string::npos &&
+                  lines[7].find(" - last message repeated 1 times") != std::string::npos &&
+                  lines[8].find(" - retry 1") != std::string::npos && lines[10].find(" - retry 2") != std::string::npos &&
+                  lines[11].find(" - runtime 0") != std::string::npos &&
+                  lines[12].find(" - runtime 1") != std::string::npos &&
+                  lines[13].find(" - last message repeated 999 times") != std::string::npos &&
+                  lines[14].find(" - last message repeated 1 times") != std::string::npos;
+    if (!passed) {
+        for (const auto& line : lines) {
+            std::cout << "  " << line << std::endl;
+        }
+    }
+    return Report("Deduplicate", passed);
+}
+
+// 多个线程同时写同一调用点时，放行和抑制的数量之和等于记录的总数，放行的数量不超过突发数量
+bool TestConcurrentSite() {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 20000;
+    std::string path = kLogDir + "/concurrent.log";
+    tinylog::LogConfig config = MakeConfig(path);
+    config.SetRateLimit(1, 20);
+
+    tinylog::LoggerStats stats;
+    {
+        tinylog::Logger logger(config);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&logger] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kError, "connect failed: {}", i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        stats = logger.GetStats();
+    }
+
+    std::vector<std::string> lines = ReadLines(path);
+    bool passed = stats.accepted + stats.suppressed == kThreads * kPerThread && stats.accepted >= 20 &&
+                  stats.accepted <= 21 && lines.size() == stats.accepted + 1 &&
+                  lines.back().find(" messages suppressed by rate limit") != std::string::npos;
+    return Report("Concurrent site", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog rate limit tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestRateLimit();
+    passed &= TestDeduplicate();
+    passed &= TestConcurrentSite();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All rate limit tests passed!" : "Some rate limit tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
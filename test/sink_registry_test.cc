@@ -0,0 +1,141 @@
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tinylog/internal/sink_registry.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./sink_registry_test_logs";
+
+tinylog::LogConfig MakeFileConfig(const std::string& path) {
+    tinylog::LogConfig config(tinylog::LogLevel::kDebug, tinylog::LogSink::kFile, path, 3, 1024 * 1024, false);
+    return config;
+}
+
+// 统计本进程打开的指向指定文件的文件描述符数量
+size_t CountOpenDescriptors(const std::string& path) {
+    std::filesystem::path target = std::filesystem::canonical(path);
+    size_t count = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd")) {
+        std::error_code ec;
+        std::filesystem::path link = std::filesystem::read_symlink(entry.path(), ec);
+        if (!ec && link == target) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// 同一文件的不同写法得到同一个sink，路径不同时得到不同的sink；
+// 参数不同时沿用已打开的sink，所有使用者释放后再获取才按新参数创建
+bool TestSinkSharing() {
+    auto& registry = tinylog::internal::SinkRegistry::GetInstance();
+    std::string path = kLogDir + "/shared.log";
+    auto first = registry.AcquireSinks(MakeFileConfig(path));
+    auto second = registry.AcquireSinks(MakeFileConfig(kLogDir + "/../" + kLogDir.substr(2) + "/./shared.log"));
+    auto other_path = registry.AcquireSinks(MakeFileConfig(kLogDir + "/other.log"));
+
+    bool shared = first.size() == 1 && second.size() == 1 && first[0] == second[0] && first[0] != other_path[0] &&
+                  first[0]->formatter() == other_path[0]->formatter();
+
+    // 参数不同的请求在已有sink打开期间得到同一个实例
+    tinylog::LogConfig changed_config = MakeFileConfig(path);
+    changed_config.SetMaxFileSize(2 * 1024 * 1024);
+    auto changed = registry.AcquireSinks(changed_config);
+    bool kept_while_open = changed[0] == first[0];
+
+    // 所有使用者释放后按新参数创建，之后原参数的请求沿用新实例
+    first.clear();
+    second.clear();
+    changed.clear();
+    auto reopened = registry.AcquireSinks(changed_config);
+    auto original = registry.AcquireSinks(MakeFileConfig(path));
+
+    bool passed = shared && kept_while_open && reopened.size() == 1 && reopened[0] == original[0];
+    return Report("Sink sharing", passed);
+}
+
+// 多个模块日志写入同一文件时共用一个文件描述符，每条日志带有模块名
+bool TestModulesShareFile() {
+    constexpr int kModules = 50;
+    std::string path = kLogDir + "/modules.log";
+    auto& manager = tinylog::LogManager::GetInstance();
+    for (int i = 0; i < kModules; ++i) {
+        tinylog::Logger& logger = manager.GetModuleLogger("shared_module_" + std::to_string(i), MakeFileConfig(path));
+        logger.LogInfo("message from module " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+    }
+    manager.FlushAll();
+
+    std::string content = ReadFile(path);
+    bool tagged = true;
+    for (int i = 0; i < kModules; ++i) {
+        std::string module = "shared_module_" + std::to_string(i);
+        tagged &= content.find("[" + module + "] ") != std::string::npos;
+        tagged &= content.find("message from module " + std::to_string(i) + "\n") != std::string::npos;
+    }
+    bool passed = tagged && CountOpenDescriptors(path) == 1;
+    return Report("Modules share file", passed);
+}
+
+// 配置相同的异步日志实例共用一个异步写入器，丢弃计数按日志实例统计
+bool TestSharedAsyncWriter() {
+    std::string path = kLogDir + "/async.log";
+    tinylog::LogConfig config = MakeFileConfig(path);
+    config.SetAsyncMode(true);
+
+    auto& registry = tinylog::internal::SinkRegistry::GetInstance();
+    auto sinks = registry.AcquireSinks(config);
+    auto writer = registry.AcquireAsyncWriter(sinks, config.GetAsyncQueueCapacity(), config.GetOverflowPolicy());
+    auto same_writer = registry.AcquireAsyncWriter(sinks, config.GetAsyncQueueCapacity(), config.GetOverflowPolicy());
+    auto other_writer = registry.AcquireAsyncWriter(sinks, config.GetAsyncQueueCapacity() * 2,
+                                                    config.GetOverflowPolicy());
+
+    size_t lines = 0;
+    {
+        tinylog::Logger first(config);
+        tinylog::Logger second(config);
+        for (int i = 0; i < 100; ++i) {
+            first.LogInfo("first " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+            second.LogInfo("second " + std::to_string(i), __FILE__, __FUNCTION__, __LINE__);
+        }
+        first.Flush();
+        second.Flush();
+        std::istringstream content(ReadFile(path));
+        std::string line;
+        while (std::getline(content, line)) {
+            ++lines;
+        }
+        lines += first.GetDroppedCount() + second.GetDroppedCount();
+    }
+
+    bool passed = writer == same_writer && writer != other_writer && lines == 200;
+    return Report("Shared async writer", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog sink registry tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestSinkSharing();
+    passed &= TestModulesShareFile();
+    passed &= TestSharedAsyncWriter();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All sink registry tests passed!" : "Some sink registry tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+// 本测试检查低级别日志宏的输出，不受构建时设置的编译期最低级别影响
+#undef TINYLOG_MIN_LEVEL
+#define TINYLOG_MIN_LEVEL TINYLOG_LEVEL_DEBUG
+
+#include "tinylog/internal/json.h"
+#include "tinylog/logger.h"
+
+#include "test_util.h"
+
+namespace {
+
+using tinylog::test::ReadFile;
+using tinylog::test::Report;
+
+const std::string kLogDir = "./structured_log_test_logs";
+
+using tinylog::kv;
+
+bool Contains(const std::string& content, const std::string& expected) {
+    if (content.find(expected) != std::string::npos) {
+        return true;
+    }
+    std::cout << "  missing: " << expected << std::endl;
+    return false;
+}
+
+tinylog::LogConfig MakeConfig(const std::string& path, tinylog::LogLayout layout, bool async_mode = false) {
+    tinylog::LogConfig config(tinylog::LogLevel::kDebug, tinylog::LogSink::kFile, path, 3, 1024 * 1024, async_mode);
+    config.SetLogLayout(layout);
+    return config;
+}
+
+std::string Escape(const std::string& str) {
+    tinylog::internal::FormatBuffer out;
+    tinylog::internal::AppendJsonEscaped(str, out);
+    return std::string(out.view());
+}
+
+// 转义覆盖所有控制字符、引号和反斜杠，其余字节原样保留；需要转义的字节出现在16字节块内任意位置都能找到
+bool TestJsonEscape() {
+    bool passed = Escape("plain text") == "plain text";
+    passed &= Escape("a\"b\\c\nd\te\x01") == "a\\\"b\\\\c\\nd\\te\\u0001";
+    passed &= Escape("caf\xc3\xa9 \x7f") == "caf\xc3\xa9 \x7f";
+
+    for (size_t length = 1; length <= 40; ++length) {
+        for (size_t pos = 0; pos < length; ++pos) {
+            std::string str(length, 'x');
+            str[pos] = '\x1f';
+            passed &= tinylog::internal::FindJsonEscape(str, 0) == pos;
+            passed &= Escape(str) == str.substr(0, pos) + "\\u001f" + str.substr(pos + 1);
+        }
+        passed &= tinylog::internal::FindJsonEscape(std::string(length, '\x80'), 0) == length;
+    }
+    return Report("JSON escape", passed);
+}
+
+// 文本格式下字段以key=value追加在日志内容之后，字段可以与格式参数混合出现
+bool TestTextFields() {
+    std::string path = kLogDir + "/text.log";
+    {
+        tinylog::Logger logger(MakeConfig(path, tinylog::LogLayout::kText));
+        logger.Info("req done", kv("status", 200), kv("latency_us", 35.5));
+        logger.Warn("user {} retry {}", kv("ok", false), 42, kv("path", "/index"), 3);
+        TINYLOG_LOGF_SITE(logger, tinylog::LogLevel::kInfo, "site {}", 1, kv("region", std::string("eu")));
+    }
+
+    std::string content = ReadFile(path);
+    bool passed = Contains(content, " - req done status=200 latency_us=35.5\n") &&
+                  Contains(content, " - user 42 retry 3 ok=false path=/index\n") &&
+                  Contains(content, " - site 1 region=eu\n");
+    return Report("Text fields", passed);
+}
+
+// JSON格式下每条日志一行，字段保留类型，日志内容和字符串值被转义
+bool TestJsonLayout() {
+    std::string path = kLogDir + "/json.log";
+    {
+        tinylog::Logger logger(MakeConfig(path, tinylog::LogLayout::kJson));
+        logger.Info("req \"{}\"\n", "a\\b", kv("status", 200), kv("ratio", 0.5), kv("ok", true), kv("name", "x\ty"),
+                    kv("nan", std::numeric_limits<double>::quiet_NaN()), kv("grade", 'A'));
+        logger.LogError("plain", "file.cc", "Func", 7);
+    }
+
+    std::string content = ReadFile(path);
+    bool passed =
+        Contains(content,
+                 "\"level\":\"INFO\",\"file\":\"" + std::string(__FILE__) + "\",\"func\":\"TestJsonLayout\",\"line\":") &&
+        Contains(content,
+                 ",\"msg\":\"req \\\"a\\\\b\\\"\\n\",\"status\":200,\"ratio\":0.5,\"ok\":true,\"name\":\"x\\ty\","
+                 "\"nan\":null,\"grade\":\"A\"}\n") &&
+        Contains(content, "\"level\":\"ERROR\",\"file\":\"file.cc\",\"func\":\"Func\",\"line\":7,\"msg\":\"plain\"}\n");
+
+    // 每一行都是以{开头、以}结尾的完整对象
+    std::istringstream lines(content);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        passed &= line.size() > 2 && line.front() == '{' && line.back() == '}' && line.rfind("{\"ts\":\"", 0) == 0;
+        ++count;
+    }
+    return Report("JSON layout", passed && count == 2);
+}
+
+// 异步模式下字段值在调用线程中复制，原字符串销毁后仍能正确输出
+bool TestAsyncFields() {
+    std::string path = kLogDir + "/async.log";
+    {
+        tinylog::Logger logger(MakeConfig(path, tinylog::LogLayout::kJson, true));
+        for (int i = 0; i < 100; ++i) {
+            std::string user = "user-" + std::to_string(i);
+            logger.Info("login", kv("user", user), kv("attempt", i));
+        }
+        logger.Flush();
+    }
+
+    std::string content = ReadFile(path);
+    bool passed = Contains(content, "\"msg\":\"login\",\"user\":\"user-0\",\"attempt\":0}\n") &&
+                  Contains(content, "\"msg\":\"login\",\"user\":\"user-99\",\"attempt\":99}\n");
+    return Report("Async fields", passed);
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog structured log tests..." << std::endl;
+
+    std::filesystem::remove_all(kLogDir);
+    std::filesystem::create_directories(kLogDir);
+
+    bool passed = true;
+    passed &= TestJsonEscape();
+    passed &= TestTextFields();
+    passed &= TestJsonLayout();
+    passed &= TestAsyncFields();
+
+    std::filesystem::remove_all(kLogDir);
+
+    std::cout << (passed ? "All structured log tests passed!" : "Some structured log tests failed!") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#ifndef TINYLOG_TEST_TEST_UTIL_H_
+#define TINYLOG_TEST_TEST_UTIL_H_
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 各测试共用的辅助函数
+namespace tinylog::test {
+
+// 输出单个测试的结果并返回是否通过
+inline bool Report(const std::string& name, bool passed) {
+    std::cout << (passed ? "✓ " : "✗ ") << name << " test " << (passed ? "passed" : "failed") << std::endl;
+    return passed;
+}
+
+// 读取整个文件，文件不存在时返回空字符串
+inline std::string ReadFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+inline std::vector<std::string> ReadLines(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+inline size_t CountLines(const std::string& path) { return ReadLines(path).size(); }
+
+// 系统临时目录下的独立目录，构造时创建，析构时连同其中的文件一起删除
+class TempDir {
+public:
+    explicit TempDir(const std::string& name)
+        : path_((std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()))).string()) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    // 目录下的文件路径
+    std::string File(const std::string& name) const { return path_ + "/" + name; }
+
+private:
+    std::string path_;
+};
+
+}  // namespace tinylog::test
+
+#endif  // TINYLOG_TEST_TEST_UTIL_H_
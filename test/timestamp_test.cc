@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include "tinylog/internal/log_utils.h"
+
+namespace {
+
+bool Check(const std::string& name, const std::string& actual, const std::string& expected) {
+    if (actual == expected) {
+        std::cout << "✓ " << name << " test passed" << std::endl;
+        return true;
+    }
+    std::cout << "✗ " << name << " test failed: expected \"" << expected << "\", got \"" << actual << "\""
+              << std::endl;
+    return false;
+}
+
+std::string Format(int64_t timestamp_ns, tinylog::TimestampPrecision precision) {
+    char buffer[tinylog::internal::kMaxTimestampLength];
+    size_t length = tinylog::internal::FormatTimestamp(timestamp_ns, precision, buffer);
+    return std::string(buffer, length);
+}
+
+bool TestClockSource(const char* name, tinylog::ClockSource source) {
+    tinylog::internal::InitClockSource(source);
+    int64_t realtime = tinylog::internal::GetCurrentTimeNanos();
+    int64_t captured = tinylog::internal::GetCurrentTimeNanos(source);
+    int64_t diff = captured > realtime ? captured - realtime : realtime - captured;
+    bool passed = diff < 100 * 1000 * 1000;  // 与实时时钟相差不超过100ms
+    std::cout << (passed ? "✓ " : "✗ ") << name << " clock test " << (passed ? "passed" : "failed")
+              << " (diff=" << diff << "ns)" << std::endl;
+    return passed;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "Running TinyLog timestamp tests..." << std::endl;
+
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    constexpr int64_t kTimestamp = 1700000000123456789LL;  // 2023-11-14 22:13:20 UTC
+
+    bool passed = true;
+    passed &= Check("Seconds precision", Format(kTimestamp, tinylog::TimestampPrecision::kSeconds),
+                    "2023-11-14 22:13:20");
+    passed &= Check("Milliseconds precision", Format(kTimestamp, tinylog::TimestampPrecision::kMilliseconds),
+                    "2023-11-14 22:13:20.123");
+    passed &= Check("Microseconds precision", Format(kTimestamp, tinylog::TimestampPrecision::kMicroseconds),
+                    "2023-11-14 22:13:20.123456");
+
+    // 同一秒内命中缓存，只更新亚秒部分
+    passed &= Check("Cached second", Format(kTimestamp + 5000000, tinylog::TimestampPrecision::kMilliseconds),
+                    "2023-11-14 22:13:20.128");
+    passed &= Check("Next second", Format(kTimestamp + 1000000000LL, tinylog::TimestampPrecision::kMilliseconds),
+                    "2023-11-14 22:13:21.123");
+    passed &= Check("Leading zeros", Format(1700000000001002003LL, tinylog::TimestampPrecision::kMicroseconds),
+                    "2023-11-14 22:13:20.001002");
+
+    passed &= TestClockSource("Realtime", tinylog::ClockSource::kRealtime);
+    passed &= TestClockSource("Coarse", tinylog::ClockSource::kCoarse);
+    passed &= TestClockSource("TSC", tinylog::ClockSource::kTsc);
+
+    std::cout << "All timestamp tests completed!" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// 将二进制格式的日志文件还原为文本或JSON Lines格式，输出到标准输出
+// 用法：tinylog-decode [--json] [--precision s|ms|us] <日志文件>...
+// 多个文件按参数顺序依次解码（例如 tinylog-decode app.log.2 app.log.1 app.log）
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tinylog/internal/binary_log.h"
+#include "tinylog/internal/formatter.h"
+#include "tinylog/internal/log_utils.h"
+#include "tinylog/internal/sink_interface.h"
+
+namespace {
+
+void PrintUsage(const char* program) {
+    fprintf(stderr, "Usage: %s [--json] [--precision s|ms|us] <file>...\n", program);
+}
+
+// 解码单个文件，返回是否完整解码
+bool DecodeFile(const std::string& path, const tinylog::internal::Formatter& formatter) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    tinylog::internal::BinaryLogReader reader(input);
+    tinylog::internal::LogEvent event;
+    tinylog::internal::FormatBuffer buffer;
+    while (reader.Next(event)) {
+        formatter.format(event, buffer);
+        fwrite(buffer.data(), 1, buffer.size(), stdout);
+    }
+    if (!reader.error().empty()) {
+        fprintf(stderr, "%s: %s\n", path.c_str(), reader.error().c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    tinylog::TimestampPrecision precision = tinylog::TimestampPrecision::kMilliseconds;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+            precision = tinylog::internal::StringToTimestampPrecision(argv[++i]);
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            PrintUsage(argv[0]);
+            return 2;
+        } else {
+            files.emplace_back(argv[i]);
+        }
+    }
+    if (files.empty()) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<tinylog::internal::Formatter> formatter;
+    if (json) {
+        formatter = std::make_unique<tinylog::internal::JsonFormatter>(precision);
+    } else {
+        formatter = std::make_unique<tinylog::internal::TextFormatter>(precision);
+    }
+
+    bool ok = true;
+    for (const auto& file : files) {
+        ok &= DecodeFile(file, *formatter);
+    }
+    fflush(stdout);
+    return ok ? 0 : 1;
+}